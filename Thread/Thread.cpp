@@ -8,417 +8,4072 @@
 #include <atomic>
 #include <string>
 #include <optional>
-#include <variant>
+#include <tuple>
+#include <cstring>
+#include <type_traits>
+#include <new>
 #include <algorithm>
+#include <iterator>
 #include <deque>
 #include <chrono>
+#include <functional>
+#include <bitset>
+#include <cmath>
+#include <cassert>
+#ifdef _WIN32
+#define NOMINMAX              // std::min / std::max 가 매크로로 바뀌지 않게
+#define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002   // 구버전 SDK
+#endif
+#if defined(_MSC_VER)
+#pragma comment(lib, "Synchronization.lib")   // WaitOnAddress
+#endif
+#else
+#include <time.h>
+#include <cerrno>
+#endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define THREAD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define THREAD_X86 0
+#endif
+
+// GCC/Clang 은 함수마다 대상 명령어 집합을 지정해야 인트린식을 쓸 수 있다 (MSVC 는 필요 없음)
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_TARGET(isa)
+#else
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
 
 // 병렬 파이프라인 버전
 // 설계 원칙:
-// 1) 더블 버퍼를 사용해 Physics는 항상 Back 버퍼(1 - front)를 쓰고,
-//    Render는 Front 버퍼(front)를 읽는다. 이렇게 하면 두 스레드가 같은 버퍼를 동시에
-//    쓰거나 읽는 일이 발생하지 않는다.
-// 2) 버퍼 인덱스 교체는 atomic store/load (release/acquire)로 일관성을 보장.
-// 3) EventQueue는 lock+deque로 안전하게 이벤트를 전달.
-// 4) Main 스레드는 이벤트 처리와 상태 출력(또는 게임 로직)을 담당.
+// 1) Transform 은 삼중 버퍼: Physics는 자기 몫의 버퍼에만 쓰고, Render는 가장 최근에 완성된
+//    버퍼를 우편함에서 가져와 읽는다. 누가 얼마나 빨리 돌든 렌더가 읽는 버퍼에는 아무도 쓰지 않는다.
+// 2) 버퍼 소유권 교환은 우편함 인덱스 하나의 atomic exchange (acq_rel)로 이루어진다.
+// 3) 이벤트는 타입마다 따로 된 채널(lock-free MPSC 링 버퍼)로 전달한다. 소비자는 자기가 읽는 타입의 연속된 배열만 훑는다.
+// 4) 게임 로직 스레드는 이벤트 큐에서 잠들어 있다가 이벤트가 오는 즉시 처리한다. Main 스레드는 프레임을 돌린다.
+
+using EntityIndex = uint32_t;
+
+// 엔티티 슬롯은 ENTITY_CHUNK_SIZE 단위로 늘어나며, 전체 상한은 MAX_ENTITY_CAPACITY
+const EntityIndex ENTITY_CHUNK_SIZE = 4096;
+const EntityIndex MAX_ENTITY_CAPACITY = 1u << 24;
+const EntityIndex INVALID_ENTITY_INDEX = UINT32_MAX;
 
-using Entity = uint32_t;
-const Entity MAX_ENTITIES = 1000;
+// 엔티티 핸들 = 슬롯 인덱스 + 세대(generation)
+// 슬롯이 파괴 후 재사용되면 세대가 올라가므로, 큐에 남아 있던 옛 핸들은 Scene::IsAlive 로 걸러낼 수 있다.
+struct Entity {
+    EntityIndex index = INVALID_ENTITY_INDEX;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+// 벽/월드를 나타내는 예약 핸들. 용량 상한보다 큰 인덱스라 실제 슬롯과 겹치지 않는다.
+const Entity WALL_ENTITY{ INVALID_ENTITY_INDEX - 1, 0 };
 
 struct TransformComponent { double x = 0.0, y = 0.0; };
 struct PhysicsComponent { double vx = 0.0, vy = 0.0; };
 struct RenderComponent { char symbol = '\0'; };
 struct HealthComponent { int health = 100; };
+struct SleepingComponent {};   // 태그: 멈춰서 물리 순회에서 빠진 엔티티 (Scene::UpdateSleeping 이 붙이고 뗀다)
 
-struct CollisionEvent { Entity a; Entity b; };
-using GameEvent = std::variant<CollisionEvent>;
+// 이벤트 타입마다 EventChannels 에 채널이 하나씩 생긴다 (GameEvents 참고)
+struct CollisionEvent { Entity a; Entity b; }; // b == WALL_ENTITY 이면 벽과의 충돌
 
-class EventQueue {
+// 캐시 라인 크기 (false sharing 방지용 패딩 단위)
+constexpr size_t CACHE_LINE = 64;
+
+// 큐가 가득 찼을 때의 동작
+enum class OverflowPolicy {
+    DropNewest, // 새 이벤트를 버리고 드롭 카운트만 올린다 (생산자는 절대 막히지 않음)
+    Block,      // 소비자가 자리를 비울 때까지 생산자가 양보하며 재시도
+};
+
+// 고정 크기 lock-free MPSC 링 버퍼 (Vyukov bounded queue 기반)
+// - 각 슬롯의 sequence 로 생산자/소비자 간 소유권을 넘긴다.
+// - 생산자끼리는 m_enqueuePos 에 대한 CAS 로만 경쟁하고, 소비자는 단일 스레드라 CAS 가 필요 없다.
+// - 생산자/소비자 커서는 서로 다른 캐시 라인에 둔다.
+// - 슬롯마다 생산자가 넣어 주는 stamp(정수 하나)를 함께 싣는다. EventQueue 는 여기에 push 시각을 담아 지연을 잰다.
+template <typename T>
+class MpscRingBuffer {
+public:
+    explicit MpscRingBuffer(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        m_mask = cap - 1;
+        m_cells = std::make_unique<Cell[]>(cap);
+        for (size_t i = 0; i < cap; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // 여러 생산자 스레드에서 호출 가능. 가득 차 있으면 false.
+    bool TryPush(T value, int64_t stamp = 0) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & m_mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(value);
+                    cell.stamp = stamp;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false; // 한 바퀴 전 슬롯을 소비자가 아직 비우지 않음 = 가득 참
+            }
+            else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 여러 생산자 스레드에서 호출 가능. 연속된 슬롯을 CAS 한 번으로 예약해 items 를 앞에서부터 넣는다.
+    // 남은 자리만큼만 넣고 실제로 넣은 개수를 반환한다 (가득 차 있으면 0).
+    size_t TryPushBatch(const T* items, size_t count, int64_t stamp = 0) {
+        if (count == 0) return 0;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t n;
+        for (;;) {
+            // 소비자 커서는 실제보다 늦게 보일 수만 있으므로 여유 공간은 항상 보수적으로 계산된다
+            size_t consumed = m_dequeuePos.load(std::memory_order_acquire);
+            size_t used = pos - consumed;
+            if (used > m_mask) {
+                // pos 가 오래된 값이면 used 가 용량을 넘을 수 있다 → 최신 값으로 재시도
+                size_t latest = m_enqueuePos.load(std::memory_order_relaxed);
+                if (latest == pos) return 0;
+                pos = latest;
+                continue;
+            }
+            n = std::min(count, m_mask + 1 - used);
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+        }
+        for (size_t k = 0; k < n; ++k) {
+            Cell& cell = m_cells[(pos + k) & m_mask];
+            cell.data = items[k];
+            cell.stamp = stamp;
+            cell.sequence.store(pos + k + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // 단일 소비자 스레드에서만 호출. stamp 가 있으면 슬롯의 stamp 를 돌려준다.
+    std::optional<T> TryPop(int64_t* stamp = nullptr) {
+        size_t head = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[head & m_mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(head + 1) < 0) return std::nullopt;
+        T value = std::move(cell.data);
+        if (stamp) *stamp = cell.stamp;
+        cell.sequence.store(head + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // 단일 소비자 스레드에서만 호출. 지금 꺼낼 수 있는 것을 최대 maxCount 개까지 out 뒤에 이어 붙인다.
+    // 커서는 마지막에 한 번만 갱신한다. stamps 가 있으면 같은 순서로 stamp 를 이어 붙인다.
+    size_t DrainInto(std::vector<T>& out, size_t maxCount = SIZE_MAX, std::vector<int64_t>* stamps = nullptr) {
+        size_t head = m_dequeuePos.load(std::memory_order_relaxed);
+        size_t n = 0;
+        while (n < maxCount) {
+            Cell& cell = m_cells[(head + n) & m_mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if ((intptr_t)seq - (intptr_t)(head + n + 1) < 0) break;
+            out.push_back(std::move(cell.data));
+            if (stamps) stamps->push_back(cell.stamp);
+            cell.sequence.store(head + n + m_mask + 1, std::memory_order_release);
+            ++n;
+        }
+        if (n) m_dequeuePos.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // 근사값: 다른 스레드가 동시에 push 중이면 바로 다음 순간에는 틀릴 수 있음
+    bool Empty() const {
+        size_t head = m_dequeuePos.load(std::memory_order_relaxed);
+        const Cell& cell = m_cells[head & m_mask];
+        return (intptr_t)cell.sequence.load(std::memory_order_acquire) - (intptr_t)(head + 1) < 0;
+    }
+
+    size_t Capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{ 0 };
+        T data{};
+        int64_t stamp = 0;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(CACHE_LINE) std::atomic<size_t> m_enqueuePos{ 0 };
+    alignas(CACHE_LINE) std::atomic<size_t> m_dequeuePos{ 0 };
+};
+
+// 기존 lock+deque 큐. 벤치마크 비교용으로만 남겨둔다.
+class LockedEventQueue {
 public:
-    void Push(GameEvent event) {
+    void Push(CollisionEvent event) {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_queue.push_back(std::move(event));
         m_cv.notify_one();
     }
 
-    // 즉시 반환하는 팝 (std::nullopt 가능)
-    std::optional<GameEvent> TryPop() {
+    std::optional<CollisionEvent> TryPop() {
         std::lock_guard<std::mutex> lock(m_mutex);
         if (m_queue.empty()) return std::nullopt;
-        GameEvent ev = std::move(m_queue.front());
+        CollisionEvent ev = std::move(m_queue.front());
         m_queue.pop_front();
         return ev;
     }
 
-    // 이벤트가 올 때까지 블로킹 팝 (종료 플래그를 외부에서 검사해야 함)
-    GameEvent WaitPop() {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_cv.wait(lock, [&] { return !m_queue.empty(); });
-        GameEvent ev = std::move(m_queue.front());
-        m_queue.pop_front();
-        return ev;
+private:
+    std::deque<CollisionEvent> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+#ifndef _WIN32
+// steady_clock 시각을 CLOCK_MONOTONIC 절대 시각으로 옮긴다.
+// 둘의 기준점이 같다고 가정하지 않고, 지금 시각 차이로 옮긴다 (이미 지났으면 false).
+inline bool ToMonotonicTimespec(std::chrono::steady_clock::time_point target, timespec& ts) {
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(target - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0) return false;
+    const int64_t ns = (int64_t)ts.tv_nsec + remaining;
+    ts.tv_sec += (time_t)(ns / 1000000000);
+    ts.tv_nsec = (long)(ns % 1000000000);
+    return true;
+}
+#endif
+
+// 이벤트카운트: "조건이 참이 될 때까지 잠들기" 를 잠금 없이 하는 주차(parking) 도구.
+// 깨우는 쪽은 잠들겠다고 알린 대기자가 있을 때만 커널에 들어가므로, 평소 Notify 는 펜스 하나와 load 하나다.
+// 대기자:  key = PrepareWait();  조건 재확인 -> 참이면 CancelWait(), 아니면 Wait(key)
+// 깨우는 쪽: 조건을 참으로 만든 뒤 NotifyOne()/NotifyAll()
+// 대기자 수 증가와 조건 발행 뒤의 seq_cst 펜스가 순서를 맞추므로, 깨우는 쪽이 대기자를 못 보면 대기자는 반드시 조건을 본다.
+// 대기자를 봤다면 세대(epoch)를 올리고 깨우므로, 그 전에 key 를 읽은 대기자는 잠들지 않거나 깨어난다.
+// 잠들기는 리눅스는 futex, Windows 는 WaitOnAddress 이고, 그 밖에는 뮤텍스/조건변수로 대신한다.
+class EventCount {
+public:
+    uint32_t PrepareWait() {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
     }
 
-    bool Empty() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_queue.empty();
+    void CancelWait() { m_waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+    // key 이후로 Notify 가 없으면 잠든다 (deadline 이 nullptr 이면 무한). 깨어나면 대기 알림을 거둔다.
+    // 가짜로 깨어날 수 있으므로 호출자는 조건을 다시 봐야 한다. deadline 이 지나서 돌아오면 false.
+    bool Wait(uint32_t key, const std::chrono::steady_clock::time_point* deadline = nullptr) {
+        const bool woken = Park(key, deadline);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        return woken;
     }
 
+    void NotifyOne() { Notify(false); }
+    void NotifyAll() { Notify(true); }
+
 private:
-    std::deque<GameEvent> m_queue;
+    void Notify(bool all) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) == 0) return;
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+#if defined(_WIN32)
+        if (all) WakeByAddressAll(&m_epoch);
+        else WakeByAddressSingle(&m_epoch);
+#elif defined(__linux__)
+        syscall(SYS_futex, FutexWord(), FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, nullptr, nullptr, 0);
+#else
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        if (all) m_cv.notify_all();
+        else m_cv.notify_one();
+#endif
+    }
+
+    bool Park(uint32_t key, const std::chrono::steady_clock::time_point* deadline) {
+#if defined(_WIN32)
+        DWORD timeoutMs = INFINITE;
+        if (deadline) {
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return false;
+            timeoutMs = (DWORD)std::min<long long>(remaining, INFINITE - 1);
+        }
+        if (WaitOnAddress(&m_epoch, &key, sizeof(key), timeoutMs)) return true;
+        return GetLastError() != ERROR_TIMEOUT;
+#elif defined(__linux__)
+        if (!deadline) {
+            syscall(SYS_futex, FutexWord(), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+            return true;
+        }
+        // FUTEX_WAIT_BITSET 의 timeout 은 CLOCK_MONOTONIC 절대 시각
+        timespec ts;
+        if (!ToMonotonicTimespec(*deadline, ts)) return false;
+        if (syscall(SYS_futex, FutexWord(), FUTEX_WAIT_BITSET_PRIVATE, key, &ts, nullptr, FUTEX_BITSET_MATCH_ANY) == 0) return true;
+        return errno != ETIMEDOUT;
+#else
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto changed = [&] { return m_epoch.load(std::memory_order_relaxed) != key; };
+        if (!deadline) { m_cv.wait(lock, changed); return true; }
+        return m_cv.wait_until(lock, *deadline, changed);
+#endif
+    }
+
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+    uint32_t* FutexWord() { return reinterpret_cast<uint32_t*>(&m_epoch); }
+#endif
+
+    alignas(CACHE_LINE) std::atomic<uint32_t> m_epoch{ 0 };   // Notify 마다 증가 (futex 가 지켜보는 값)
+    std::atomic<uint32_t> m_waiters{ 0 };                      // PrepareWait 했고 아직 깨어나지 않은 대기자
+#if !defined(_WIN32) && !defined(__linux__)
     std::mutex m_mutex;
     std::condition_variable m_cv;
+#endif
 };
 
-class Scene {
+// 이벤트 지연 측정용 시각 (steady_clock, ns)
+inline int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 이벤트 타입 T 하나의 채널: 생산자(Physics 등) -> 소비자(게임 로직) 큐
+// 내부는 lock-free 링 버퍼이고, 소비자는 EventCount 로 잠든다.
+// 생산자는 대기 중인 소비자가 있을 때만 커널에 들어가므로 평상시 Push 는 CAS 한 번과 펜스 하나로 끝난다.
+// SetPushStamps(true) 면 이벤트마다 push 시각(SteadyNowNs)이 함께 실려 소비자가 push -> 처리 지연을 잴 수 있다.
+// 시계 읽기는 Push 한 번의 비용과 맞먹으므로 기본은 꺼 두고 stamp 0 을 싣는다 (배치는 배치당 한 번만 읽는다).
+template <typename T>
+class EventQueue {
 public:
-    Scene() {
-        m_transforms[0].resize(MAX_ENTITIES);
-        m_transforms[1].resize(MAX_ENTITIES);
-        m_physics.resize(MAX_ENTITIES);
-        m_renders.resize(MAX_ENTITIES);
-        m_healths.resize(MAX_ENTITIES);
-        m_entity_active.resize(MAX_ENTITIES, false);
+    explicit EventQueue(size_t capacity = 1 << 16, OverflowPolicy policy = OverflowPolicy::Block)
+        : m_ring(capacity), m_policy(policy) {}
+
+    void Push(T event) {
+        const int64_t now = m_stampPushes ? SteadyNowNs() : 0;
+        while (!m_ring.TryPush(event, now)) {
+            if (m_policy == OverflowPolicy::DropNewest || IsClosed()) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+        WakeConsumer();
     }
 
-    Entity CreateEntity() {
-        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
-            if (!m_entity_active[i]) {
-                m_entity_active[i] = true;
-                return i;
+    // 한 틱 동안 모은 이벤트를 한 번에 넣는다. 자리가 있으면 슬롯 예약과 소비자 깨우기가 배치당 한 번씩만 일어난다.
+    // 배치가 남은 자리보다 크면 넣은 만큼씩 소비자를 깨운다. 잠든 소비자가 자리를 비워 줘야 나머지를 넣을 수 있다.
+    void PushBatch(const std::vector<T>& batch) {
+        const T* data = batch.data();
+        size_t remaining = batch.size();
+        if (remaining == 0) return;
+        const int64_t now = m_stampPushes ? SteadyNowNs() : 0;
+        while (remaining > 0) {
+            size_t pushed = m_ring.TryPushBatch(data, remaining, now);
+            data += pushed;
+            remaining -= pushed;
+            if (pushed > 0) {
+                WakeConsumer();
+            } else {
+                if (m_policy == OverflowPolicy::DropNewest || IsClosed()) {
+                    m_dropped.fetch_add(remaining, std::memory_order_relaxed);
+                    break;
+                }
+                std::this_thread::yield();
             }
         }
-        return MAX_ENTITIES;
     }
 
-    // 기존 접근자 (편의성 유지)
-    std::vector<TransformComponent>& GetTransforms_Front() { return m_transforms[m_frontBufferIndex.load()]; }
-    std::vector<TransformComponent>& GetTransforms_Back() { return m_transforms[1 - m_frontBufferIndex.load()]; }
+    // 즉시 반환하는 팝 (std::nullopt 가능) - 소비자 스레드 전용
+    std::optional<T> TryPop(int64_t* pushedNs = nullptr) {
+        return m_ring.TryPop(pushedNs);
+    }
 
-    void SwapTransformBuffers() { m_frontBufferIndex.store(1 - m_frontBufferIndex.load()); }
+    // 쌓여 있는 이벤트를 out 뒤에 연속으로 옮긴다 (소비자 스레드 전용). 옮긴 개수를 반환.
+    // pushedNs 가 있으면 이벤트마다 push 시각을 같은 순서로 이어 붙인다.
+    size_t DrainInto(std::vector<T>& out, size_t maxCount = SIZE_MAX, std::vector<int64_t>* pushedNs = nullptr) {
+        return m_ring.DrainInto(out, maxCount, pushedNs);
+    }
 
-    std::vector<PhysicsComponent>& GetPhysics() { return m_physics; }
-    std::vector<RenderComponent>& GetRenders() { return m_renders; }
-    std::vector<HealthComponent>& GetHealths() { return m_healths; }
-    const std::vector<bool>& GetActiveEntities() const { return m_entity_active; }
+    // 아래 대기 함수들은 모두 소비자 스레드 전용이다. 이벤트가 오거나, 시간이 다 되거나, Close 될 때까지 기다린다.
+    // 닫힌 뒤에도 남은 이벤트는 계속 꺼내 주고, 비어 있으면 잠들지 않고 바로 돌아온다.
 
-    // 병렬 파이프라인용 안전 접근자들:
-    // front 인덱스 읽기/쓰기 (원자적, 메모리 순서 지정)
-    int LoadFrontIndex() const { return m_frontBufferIndex.load(std::memory_order_acquire); }
-    void StoreFrontIndex(int idx) { m_frontBufferIndex.store(idx, std::memory_order_release); }
+    // 이벤트가 올 때까지 (또는 Close 까지) 기다리는 팝. 닫혀서 돌아오면 std::nullopt.
+    std::optional<T> WaitPop(int64_t* pushedNs = nullptr) {
+        std::optional<T> ev;
+        WaitAndTake(nullptr, [&] { return (ev = m_ring.TryPop(pushedNs)).has_value(); });
+        return ev;
+    }
 
-    // 특정 인덱스의 transform 벡터 직접 참조 (주의: 호출자는 해당 버퍼를 다른 스레드가 쓰지 않음을 보장해야 함)
-    std::vector<TransformComponent>& GetTransformsAt(int idx) { return m_transforms[idx]; }
-    const std::vector<TransformComponent>& GetTransformsAtConst(int idx) const { return m_transforms[idx]; }
+    std::optional<T> WaitPopUntil(std::chrono::steady_clock::time_point deadline, int64_t* pushedNs = nullptr) {
+        std::optional<T> ev;
+        WaitAndTake(&deadline, [&] { return (ev = m_ring.TryPop(pushedNs)).has_value(); });
+        return ev;
+    }
 
-private:
-    std::atomic<int> m_frontBufferIndex{ 0 };
-    std::vector<TransformComponent> m_transforms[2]; // 더블 버퍼
+    std::optional<T> WaitPopFor(std::chrono::nanoseconds timeout, int64_t* pushedNs = nullptr) {
+        return WaitPopUntil(std::chrono::steady_clock::now() + timeout, pushedNs);
+    }
 
-    std::vector<PhysicsComponent> m_physics;
-    std::vector<RenderComponent> m_renders;
-    std::vector<HealthComponent> m_healths;
-    std::vector<bool> m_entity_active;
-};
-std::vector<TransformComponent> m_transforms[2];
-std::vector<PhysicsComponent> m_physics;
-std::vector<RenderComponent> m_renders;
-std::vector<HealthComponent> m_healths;
-std::vector<bool> m_entity_active;
-};
+    // 한 번 깨어날 때 쌓여 있는 것을 최대 maxCount 개까지 out 뒤에 옮긴다 (pushedNs 는 DrainInto 와 같음).
+    // 이벤트가 몰려 올 때 잠들고 깨는 비용을 이벤트 하나가 아니라 묶음 하나에 한 번만 낸다. 옮긴 개수를 반환.
+    // PushBatch 는 들어간 조각마다 깨우므로, 용량보다 큰 배치(Block)도 첫 조각부터 받아 자리를 비워 준다.
+    size_t WaitPopBatch(std::vector<T>& out, size_t maxCount, std::chrono::nanoseconds timeout,
+        std::vector<int64_t>* pushedNs = nullptr) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        size_t taken = 0;
+        WaitAndTake(&deadline, [&] { return (taken = m_ring.DrainInto(out, maxCount, pushedNs)) > 0; });
+        return taken;
+    }
 
-class PhysicsSystem {
-public:
-    // 기존 직렬 Update를 남겨둘 수 있지만 병렬 파이프라인에선 아래 UpdateParallel을 사용
-    void Update(Scene& scene, EventQueue& events) {
-        // legacy (unused)
-        auto& transforms_front = scene.GetTransforms_Front();
-        auto& transforms_back = scene.GetTransforms_Back();
-        auto& physics = scene.GetPhysics();
-        const auto& active = scene.GetActiveEntities();
+    // 종료 알림. 기다리는 소비자를 모두 깨우고, 이후의 대기는 잠들지 않고 바로 돌아온다.
+    // Push 는 자리가 있으면 계속 받지만, 가득 찬 큐에서 Block 으로 기다리던 생산자는 더 기다리지 않고 버린다
+    // (소비자가 이미 떠났을 수 있으므로).
+    void Close() {
+        m_closed.store(true, std::memory_order_release);
+        m_notEmpty.NotifyAll();
+    }
+
+    bool IsClosed() const { return m_closed.load(std::memory_order_acquire); }
 
-        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
-            if (!active[i]) continue;
-            transforms_back[i] = transforms_front[i];
-            if (physics[i].vx != 0.0 || physics[i].vy != 0.0) {
-                transforms_back[i].x += physics[i].vx;
-                transforms_back[i].y += physics[i].vy;
+    // 생산자가 돌기 전에 설정한다
+    void SetPushStamps(bool enabled) { m_stampPushes = enabled; }
+
+    bool Empty() const { return m_ring.Empty(); }
+
+    size_t DroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // 대기 공통 부분. take() 가 true 를 반환하거나, deadline(nullptr 이면 무한)이 지나거나, 닫힐 때까지 기다린다.
+    // 포기하기 직전에 한 번 더 시도하므로 시간이 다 되거나 닫히는 순간 도착한 이벤트도 놓치지 않는다.
+    template <typename Take>
+    bool WaitAndTake(const std::chrono::steady_clock::time_point* deadline, Take&& take) {
+        if (take()) return true;
+        for (;;) {
+            // 잠들기 전에 대기 중임을 알리고 다시 확인 (EventCount 참고). Close 도 같은 방식으로 알린다.
+            const uint32_t key = m_notEmpty.PrepareWait();
+            if (take()) {
+                m_notEmpty.CancelWait();
+                return true;
             }
+            if (m_closed.load(std::memory_order_acquire)) {
+                m_notEmpty.CancelWait();
+                break;
+            }
+            if (!m_notEmpty.Wait(key, deadline)) break;
         }
-        scene.SwapTransformBuffers();
+        return take();
     }
 
-    // 병렬 파이프라인용 Update: frontIndex를 읽어 back 버퍼에 쓰고, 완료 시 atomic으로 front를 교체
-    void UpdateParallel(Scene& scene, EventQueue& events) {
-        // 현재 front 인덱스(렌더가 읽는 버퍼)
-        int curFront = scene.LoadFrontIndex();
-        int back = 1 - curFront;
-
-        auto& transforms_front = scene.GetTransformsAt(curFront);
-        auto& transforms_back = scene.GetTransformsAt(back);
-        auto& physics = scene.GetPhysics();
-        const auto& active = scene.GetActiveEntities();
+    void WakeConsumer() { m_notEmpty.NotifyOne(); }
 
-        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
-            if (!active[i]) continue;
+    MpscRingBuffer<T> m_ring;
+    OverflowPolicy m_policy;
+    bool m_stampPushes = false;
+    EventCount m_notEmpty;
+    std::atomic<bool> m_closed{ false };
+    std::atomic<size_t> m_dropped{ 0 };
+};
 
-            // front의 값을 읽어 back으로 복사
-            transforms_back[i] = transforms_front[i];
+// 이벤트 타입별 채널 묶음. 타입마다 링 버퍼가 따로라, 소비자는 std::variant 분기 없이 한 타입의 연속된 배열을 훑고
+// 새 이벤트 타입이 생겨도 그 타입을 읽지 않는 시스템은 아무 비용도 내지 않는다.
+// 생산자는 틱마다 타입별로 모은 배치를 자기 채널에 한 번 PushBatch 한다.
+template <typename... Events>
+class EventChannels {
+public:
+    explicit EventChannels(size_t capacity = 1 << 16, OverflowPolicy policy = OverflowPolicy::Block)
+        : m_channels(std::make_unique<EventQueue<Events>>(capacity, policy)...) {}
 
-            if (physics[i].vx != 0.0 || physics[i].vy != 0.0) {
-                transforms_back[i].x += physics[i].vx;
-                transforms_back[i].y += physics[i].vy;
+    template <typename E>
+    EventQueue<E>& Channel() { return *std::get<std::unique_ptr<EventQueue<E>>>(m_channels); }
 
-                // 경계 보정 및 이벤트
-                if (transforms_back[i].x < 0) { transforms_back[i].x = 0; physics[i].vx *= -1; events.Push(CollisionEvent{ i, MAX_ENTITIES }); }
-                if (transforms_back[i].x > 79) { transforms_back[i].x = 79; physics[i].vx *= -1; events.Push(CollisionEvent{ i, MAX_ENTITIES }); }
-                if (transforms_back[i].y < 0) { transforms_back[i].y = 0; physics[i].vy *= -1; events.Push(CollisionEvent{ i, MAX_ENTITIES }); }
-                if (transforms_back[i].y > 24) { transforms_back[i].y = 24; physics[i].vy *= -1; events.Push(CollisionEvent{ i, MAX_ENTITIES }); }
-            }
-        }
+    // 모든 채널을 닫는다 (EventQueue::Close)
+    void Close() { (Channel<Events>().Close(), ...); }
+    void SetPushStamps(bool enabled) { (Channel<Events>().SetPushStamps(enabled), ...); }
+    size_t DroppedCount() { return (Channel<Events>().DroppedCount() + ...); }
 
-        // 모든 쓰기가 끝나면 front를 back으로 교체 (release)
-        scene.StoreFrontIndex(back);
-    }
+private:
+    std::tuple<std::unique_ptr<EventQueue<Events>>...> m_channels;   // 링 버퍼가 옮겨지지 않게 따로 할당
 };
 
-struct RenderPacket { char symbol; int x, y; };
+using GameEvents = EventChannels<CollisionEvent>;
 
-class RenderSystem {
+// ENTITY_CHUNK_SIZE 개씩 따로 할당하는 배열. 늘어나도 기존 원소는 절대 이동하지 않는다.
+// 청크 디렉터리는 상한 크기로 미리 잡아두므로, 다른 스레드가 이미 공개된 범위를 읽는 중에도
+// 쓰기 스레드가 뒤에 청크를 붙일 수 있다 (공개 자체는 Scene 의 capacity atomic 이 담당).
+template <typename T>
+class ChunkedArray {
 public:
-    void Collect(const Scene& scene, std::vector<RenderPacket>& packets) {
-        packets.clear();
-        const auto& transforms = scene.GetTransforms_Front();
-        const auto& renders = scene.GetRenders();
-        const auto& active = scene.GetActiveEntities();
+    ChunkedArray()
+        : m_chunks(std::make_unique<std::unique_ptr<T[]>[]>(MAX_ENTITY_CAPACITY / ENTITY_CHUNK_SIZE)) {}
 
-        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
-            if (active[i] && renders[i].symbol != ' ') {
-                packets.push_back({ renders[i].symbol, (int)transforms[i].x, (int)transforms[i].y });
-            }
-        }
+    ChunkedArray(const ChunkedArray&) = delete;
+    ChunkedArray& operator=(const ChunkedArray&) = delete;
+
+    // 청크 하나를 기본값으로 채워 뒤에 붙인다
+    void AddChunk() {
+        m_chunks[m_chunkCount] = std::make_unique<T[]>(ENTITY_CHUNK_SIZE);
+        ++m_chunkCount;
     }
 
-    // 병렬 파이프라인용 수집: 현재 front 인덱스를 atomic으로 읽고 해당 버퍼를 스냅샷처럼 사용
-    void CollectParallel(const Scene& scene, std::vector<RenderPacket>& packets) {
-        packets.clear();
-        int curFront = scene.LoadFrontIndex();
-        const auto& transforms = scene.GetTransformsAtConst(curFront);
-        const auto& renders = scene.GetRenders();
-        const auto& active = scene.GetActiveEntities();
+    size_t Size() const { return m_chunkCount * ENTITY_CHUNK_SIZE; }
 
-        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
-            if (active[i] && renders[i].symbol != ' ') {
-                packets.push_back({ renders[i].symbol, (int)transforms[i].x, (int)transforms[i].y });
-            }
-        }
-    }
+    T& operator[](size_t i) { return m_chunks[i / ENTITY_CHUNK_SIZE][i % ENTITY_CHUNK_SIZE]; }
+    const T& operator[](size_t i) const { return m_chunks[i / ENTITY_CHUNK_SIZE][i % ENTITY_CHUNK_SIZE]; }
+
+private:
+    std::unique_ptr<std::unique_ptr<T[]>[]> m_chunks;
+    size_t m_chunkCount = 0;
 };
 
-class RenderSystem {
+// 컴포넌트 하나를 위한 sparse set 저장소
+// - sparse: 엔티티 인덱스 -> dense 위치 (없으면 INVALID_ENTITY_INDEX). Scene 용량과 함께 청크 단위로 늘어난다.
+// - dense: 이 컴포넌트를 가진 엔티티 인덱스와 컴포넌트 값을 같은 순서로 빽빽하게 저장
+// 시스템은 Entities()/Data() 를 [0, Size()) 로 순회하면 존재 여부 검사 없이 소유 엔티티만 돈다.
+// 추가/제거는 dense 배열을 재배치할 수 있으므로 시스템이 순회 중이 아닐 때만 호출해야 한다.
+template <typename T>
+class SparseSet {
 public:
-    void Collect(const Scene& scene, std::vector<RenderPacket>& packets) {
-        packets.clear();
-        const auto& transforms = scene.GetTransforms_Front();
-        const auto& renders = scene.GetRenders();
-        const auto& active = scene.GetActiveEntities();
+    void AddChunk(EntityIndex firstIndex) {
+        m_sparse.AddChunk();
+        for (EntityIndex i = firstIndex; i < firstIndex + ENTITY_CHUNK_SIZE; ++i) m_sparse[i] = INVALID_ENTITY_INDEX;
+    }
 
-        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
-            if (active[i] && renders[i].symbol != '\0') {
-                packets.push_back({ renders[i].symbol, (int)transforms[i].x, (int)transforms[i].y });
-            }
+    bool Contains(EntityIndex e) const { return m_sparse[e] != INVALID_ENTITY_INDEX; }
+
+    // 이미 있으면 값을 덮어쓴다
+    T& Emplace(EntityIndex e, T value) {
+        EntityIndex pos = m_sparse[e];
+        if (pos != INVALID_ENTITY_INDEX) {
+            m_data[pos] = std::move(value);
+            return m_data[pos];
         }
+        m_sparse[e] = (EntityIndex)m_dense.size();
+        m_dense.push_back(e);
+        m_data.push_back(std::move(value));
+        return m_data.back();
+    }
+
+    // swap-remove
+    bool Remove(EntityIndex e) {
+        EntityIndex pos = m_sparse[e];
+        if (pos == INVALID_ENTITY_INDEX) return false;
+        EntityIndex lastEntity = m_dense.back();
+        m_dense[pos] = lastEntity;
+        m_data[pos] = std::move(m_data.back());
+        m_sparse[lastEntity] = pos;
+        m_sparse[e] = INVALID_ENTITY_INDEX;
+        m_dense.pop_back();
+        m_data.pop_back();
+        return true;
+    }
+
+    T* TryGet(EntityIndex e) {
+        EntityIndex pos = m_sparse[e];
+        return pos == INVALID_ENTITY_INDEX ? nullptr : &m_data[pos];
     }
+    const T* TryGet(EntityIndex e) const {
+        EntityIndex pos = m_sparse[e];
+        return pos == INVALID_ENTITY_INDEX ? nullptr : &m_data[pos];
+    }
+
+    size_t Size() const { return m_dense.size(); }
+    const EntityIndex* Entities() const { return m_dense.data(); }
+    T* Data() { return m_data.data(); }
+    const T* Data() const { return m_data.data(); }
+
+private:
+    ChunkedArray<EntityIndex> m_sparse;
+    std::vector<EntityIndex> m_dense;
+    std::vector<T> m_data;
 };
 
-class DamageSystem {
-public:
-    // 이벤트를 모두 비울 때까지 처리한다 (메인 루프에서 호출)
-    void DrainAndApply(Scene& scene, EventQueue& events) {
-        auto& healths = scene.GetHealths();
-        while (true) {
-            auto evOpt = events.TryPop();
-            if (!evOpt) break;
-            std::visit([&](auto&& arg) {
-                using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, CollisionEvent>) {
-                    if (arg.b == MAX_ENTITIES) {
-                        if (healths[arg.a].health > 0) {
-                            healths[arg.a].health = std::max(0, healths[arg.a].health - 10);
-                            std::cout << "[Event] Entity " << arg.a << " hit a wall! HP: " << healths[arg.a].health << std::endl;
-                        }
-                    }
+// ---------------------------------------------------------------------------
+// 아키타입(Archetype) 저장소
+// 같은 컴포넌트 조합을 가진 엔티티들을 ARCHETYPE_CHUNK_BYTES 크기의 청크에 모아 두고,
+// 청크 안에서는 컴포넌트마다 열(column)을 따로 둔다. 쿼리는 조건에 맞는 청크들의 열을 앞에서부터 훑는다.
+// Transform 은 삼중 버퍼라 청크 안에 열이 TRANSFORM_BUFFERS 개 있다 (TripleBufferMailbox 참고).
+// Transform/Physics 는 SoA 로 저장한다: 필드(x, y / vx, vy)마다 64바이트 정렬된 배열을 따로 두어
+// 적분 루프가 연속된 double 배열을 훑게 한다 (벡터화 가능). 나머지는 구조체 배열(AoS) 열이다.
+// 체력처럼 이벤트로 하나씩 찾아가는 컴포넌트는 sparse set 에 둔다 (StorageKind::Sparse).
+// ---------------------------------------------------------------------------
+
+const size_t ARCHETYPE_CHUNK_BYTES = 16 * 1024;
+const int TRANSFORM_BUFFERS = 3;
+const int MAX_COMPONENT_BUFFERS = 3;
+const int MAX_COMPONENT_FIELDS = 2;
+
+enum class StorageKind { Table, Sparse };
+
+// SoA 컴포넌트의 필드 배열 묶음. 필드 순서는 구조체 멤버 순서와 같다.
+struct ConstTransformColumns { const double* x; const double* y; };
+struct ConstPhysicsColumns { const double* vx; const double* vy; };
+struct TransformColumns {
+    double* x; double* y;
+    operator ConstTransformColumns() const { return { x, y }; }
+};
+struct PhysicsColumns {
+    double* vx; double* vy;
+    operator ConstPhysicsColumns() const { return { vx, vy }; }
+};
+
+using ComponentMask = uint32_t;
+
+template <typename T> struct ComponentTraits;
+// Fields > 1 이면 SoA: 구조체를 같은 크기의 필드 Fields 개로 쪼개 필드별 배열에 저장한다.
+template <> struct ComponentTraits<TransformComponent> {
+    static constexpr uint32_t Id = 0; static constexpr StorageKind Storage = StorageKind::Table; static constexpr int Buffers = TRANSFORM_BUFFERS;
+    static constexpr int Fields = 2; using Columns = TransformColumns; using ConstColumns = ConstTransformColumns;
+};
+template <> struct ComponentTraits<PhysicsComponent> {
+    static constexpr uint32_t Id = 1; static constexpr StorageKind Storage = StorageKind::Table; static constexpr int Buffers = 1;
+    static constexpr int Fields = 2; using Columns = PhysicsColumns; using ConstColumns = ConstPhysicsColumns;
+};
+template <> struct ComponentTraits<RenderComponent> { static constexpr uint32_t Id = 2; static constexpr StorageKind Storage = StorageKind::Table; static constexpr int Buffers = 1; static constexpr int Fields = 1; };
+// 태그는 마스크 비트만 있고 열이 없다 (Buffers = 0)
+template <> struct ComponentTraits<SleepingComponent> { static constexpr uint32_t Id = 3; static constexpr StorageKind Storage = StorageKind::Table; static constexpr int Buffers = 0; static constexpr int Fields = 1; };
+template <> struct ComponentTraits<HealthComponent> { static constexpr uint32_t Id = 4; static constexpr StorageKind Storage = StorageKind::Sparse; static constexpr int Buffers = 1; static constexpr int Fields = 1; };
+
+// 테이블 컴포넌트 메타데이터 (Id 순서). 청크 사이 이동은 memcpy 로 하므로 모두 trivially copyable 이어야 한다.
+const uint32_t TABLE_COMPONENT_COUNT = 4;
+struct ComponentInfo {
+    size_t size; int buffers; int fields;
+    size_t FieldSize() const { return size / fields; }
+};
+const ComponentInfo TABLE_COMPONENTS[TABLE_COMPONENT_COUNT] = {
+    { sizeof(TransformComponent), TRANSFORM_BUFFERS, ComponentTraits<TransformComponent>::Fields },
+    { sizeof(PhysicsComponent), 1, ComponentTraits<PhysicsComponent>::Fields },
+    { sizeof(RenderComponent), 1, ComponentTraits<RenderComponent>::Fields },
+    { 0, 0, ComponentTraits<SleepingComponent>::Fields },
+};
+static_assert(sizeof(TransformComponent) == 2 * sizeof(double) && sizeof(PhysicsComponent) == 2 * sizeof(double),
+    "SoA components are split into equally sized fields without padding");
+static_assert(std::is_trivially_copyable_v<TransformComponent> && std::is_trivially_copyable_v<PhysicsComponent>
+    && std::is_trivially_copyable_v<RenderComponent> && std::is_trivially_copyable_v<SleepingComponent>, "table components are moved with memcpy");
+
+template <typename... Ts>
+constexpr ComponentMask MaskOf() { return (0u | ... | (1u << ComponentTraits<Ts>::Id)); }
+
+template <typename T>
+constexpr bool IsTableComponent() { return ComponentTraits<T>::Storage == StorageKind::Table; }
+
+template <typename T>
+constexpr bool IsSoAComponent() { return IsTableComponent<T>() && ComponentTraits<T>::Fields > 1; }
+
+// 빈 슬롯(생성 전, 파괴 후)의 archetype
+const uint32_t NO_ARCHETYPE = UINT32_MAX;
+
+// 엔티티가 어느 아키타입의 몇 번째 청크, 몇 번째 행에 있는지
+struct EntityLocation {
+    uint32_t archetype = NO_ARCHETYPE;
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+};
+
+// 아키타입 하나의 청크 내부 배치. 모든 열(SoA 면 필드 배열 하나하나)은 캐시 라인 경계에서 시작한다.
+struct ArchetypeLayout {
+    ComponentMask mask = 0;
+    uint32_t rows = 0;
+    uint32_t entityOffset = 0;
+    uint32_t offsets[TABLE_COMPONENT_COUNT][MAX_COMPONENT_BUFFERS][MAX_COMPONENT_FIELDS] = {};
+
+    static size_t AlignUp(size_t v) { return (v + CACHE_LINE - 1) & ~(CACHE_LINE - 1); }
+
+    // rows 행일 때 필요한 바이트 수 (오프셋도 함께 채움)
+    size_t Place(uint32_t rowCount) {
+        size_t off = 0;
+        entityOffset = (uint32_t)off;
+        off = AlignUp(off + rowCount * sizeof(EntityIndex));
+        for (uint32_t c = 0; c < TABLE_COMPONENT_COUNT; ++c) {
+            if (!(mask & (1u << c))) continue;
+            for (int b = 0; b < TABLE_COMPONENTS[c].buffers; ++b) {
+                for (int f = 0; f < TABLE_COMPONENTS[c].fields; ++f) {
+                    offsets[c][b][f] = (uint32_t)off;
+                    off = AlignUp(off + rowCount * TABLE_COMPONENTS[c].FieldSize());
                 }
-                }, *evOpt);
+            }
         }
+        return off;
+    }
+
+    explicit ArchetypeLayout(ComponentMask m) : mask(m) {
+        size_t rowBytes = sizeof(EntityIndex);
+        for (uint32_t c = 0; c < TABLE_COMPONENT_COUNT; ++c)
+            if (mask & (1u << c)) rowBytes += TABLE_COMPONENTS[c].size * TABLE_COMPONENTS[c].buffers;
+        uint32_t n = (uint32_t)(ARCHETYPE_CHUNK_BYTES / rowBytes);
+        while (n > 1 && Place(n) > ARCHETYPE_CHUNK_BYTES) --n; // 정렬 패딩만큼 줄인다
+        rows = n;
+        Place(rows);
     }
 };
 
-void ClearScreen() {
-    HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    if (hStdOut == INVALID_HANDLE_VALUE) return;
-    CONSOLE_SCREEN_BUFFER_INFO csbi;
-    if (!GetConsoleScreenBufferInfo(hStdOut, &csbi)) return;
-    DWORD cellCount = csbi.dwSize.X * csbi.dwSize.Y;
-    DWORD written;
-    COORD homeCoords = { 0, 0 };
-    FillConsoleOutputCharacter(hStdOut, (TCHAR)' ', cellCount, homeCoords, &written);
-    FillConsoleOutputAttribute(hStdOut, csbi.wAttributes, cellCount, homeCoords, &written);
-    SetConsoleCursorPosition(hStdOut, homeCoords);
+struct alignas(CACHE_LINE) ChunkMemory { unsigned char bytes[ARCHETYPE_CHUNK_BYTES]; };
+
+inline uint32_t CountTrailingZeros64(uint64_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanForward64(&index, v);
+#else
+    // 32비트 빌드에는 64비트 스캔이 없다: 아래 절반부터
+    if (_BitScanForward(&index, (unsigned long)v)) return (uint32_t)index;
+    _BitScanForward(&index, (unsigned long)(v >> 32));
+    index += 32;
+#endif
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(v);
+#endif
 }
 
-class Renderer {
+// bits 에서 연속으로 켜진 구간마다 fn(begin, end) 호출 (n 행 범위)
+template <typename Fn>
+void ForEachBitRun(const uint64_t* bits, uint32_t n, Fn&& fn) {
+    const uint32_t words = (n + 63) / 64;
+    uint32_t r = 0;
+    while (r < n) {
+        // 다음 켜진 비트
+        uint32_t w = r / 64;
+        uint64_t word = bits[w] & (~0ull << (r % 64));
+        while (!word && ++w < words) word = bits[w];
+        if (!word) return;
+        const uint32_t begin = w * 64 + CountTrailingZeros64(word);
+        if (begin >= n) return;
+        // 그다음 꺼진 비트
+        word = ~bits[w] & (~0ull << (begin % 64));
+        while (!word && ++w < words) word = ~bits[w];
+        const uint32_t end = word ? std::min(n, w * 64 + CountTrailingZeros64(word)) : n;
+        fn(begin, end);
+        r = end;
+    }
+}
+
+// 16 KiB 청크 하나. 앞쪽 Count() 개 행만 유효하다.
+class ArchetypeChunk {
 public:
-    void Draw(const std::vector<RenderPacket>& packets, const Scene& scene) {
-        ClearScreen();
-        char screen[25][81];
-        for (int y = 0; y < 25; ++y) for (int x = 0; x < 81; ++x) screen[y][x] = ' ';
-        for (int i = 0; i < 25; ++i) screen[i][80] = '\0';
+    explicit ArchetypeChunk(const ArchetypeLayout* layout)
+        : m_layout(layout), m_memory(std::make_unique<ChunkMemory>()) {
+        if (layout->mask & MaskOf<TransformComponent>()) {
+            const size_t words = (layout->rows + 63) / 64;
+            m_moving.assign(words, 0);
+            for (auto& stale : m_stale) stale.assign(words, 0);
+        }
+    }
 
-        for (const auto& p : packets) {
-            if (p.y >= 0 && p.y < 25 && p.x >= 0 && p.x < 80) screen[p.y][p.x] = p.symbol;
+    uint32_t Count() const { return m_count; }
+    ComponentMask Mask() const { return m_layout->mask; }
+    const EntityIndex* Entities() const { return (const EntityIndex*)(m_memory->bytes + m_layout->entityOffset); }
+
+    // Transform 변경 추적 (Transform 이 있는 청크만, 행마다 1비트, Count() 뒤의 비트는 항상 0)
+    //   moving: 속도가 0 이 아닌 행. 물리가 값을 바꾸는 행이다.
+    //   stale[b]: 버퍼 b 의 값이 가장 최근에 발행된 값과 다를 수 있는 행
+    // 물리는 moving | stale[dst] 인 행만 읽고 쓰면 된다. 구조 변경은 보수적으로 모든 버퍼를 stale 로 표시한다.
+    const uint64_t* MovingRows() const { return m_moving.data(); }
+    const uint64_t* StaleRows(int buffer) const { return m_stale[buffer].data(); }
+
+    // 물리가 buffer 에 (moving | stale[buffer]) 행을 다 쓴 뒤: buffer 는 최신이 되고, 움직인 행은 다른 버퍼에서 낡는다
+    void CommitTransformWrite(int buffer) {
+        for (size_t w = 0; w < m_moving.size(); ++w) {
+            for (int b = 0; b < TRANSFORM_BUFFERS; ++b)
+                m_stale[b][w] = b == buffer ? 0 : (m_stale[b][w] | m_moving[w]);
         }
+    }
 
-        for (int y = 0; y < 25; ++y) printf("%s\n", screen[y]);
-        printf("--------------------------------------------------------------------------------\n");
-        const auto& active = scene.GetActiveEntities();
-        const auto& healths = scene.GetHealths();
-        for (Entity i = 0; i < 10; ++i) {
-            if (active[i]) printf("[Entity %d] HP: %d | ", i, healths[i].health);
+    // Transform/Physics 열을 직접 고친 뒤 호출 (Scene::Each 등). 모든 행을 다시 복사하고 움직임 여부를 다시 본다.
+    void TouchAllRows() { for (uint32_t r = 0; r < m_count; ++r) TouchRow(r); }
+
+    // AoS 열
+    template <typename T> T* Column(int buffer = 0) {
+        static_assert(IsTableComponent<T>() && !IsSoAComponent<T>(), "Column<T> is for AoS table components; use Columns<T>");
+        return (T*)(m_memory->bytes + m_layout->offsets[ComponentTraits<T>::Id][buffer][0]);
+    }
+    template <typename T> const T* Column(int buffer = 0) const { return const_cast<ArchetypeChunk*>(this)->Column<T>(buffer); }
+
+    // SoA 필드 배열 하나 (field 는 구조체 멤버 순서)
+    template <typename T> double* FieldColumn(int field, int buffer = 0) const {
+        static_assert(IsSoAComponent<T>(), "FieldColumn<T> is for SoA table components; use Column<T>");
+        return (double*)FieldArray(ComponentTraits<T>::Id, buffer, field);
+    }
+
+    // SoA 필드 배열 묶음 (예: Columns<TransformComponent>(back).x)
+    template <typename T> typename ComponentTraits<T>::Columns Columns(int buffer = 0) {
+        return { FieldColumn<T>(0, buffer), FieldColumn<T>(1, buffer) };
+    }
+    template <typename T> typename ComponentTraits<T>::ConstColumns Columns(int buffer = 0) const {
+        return { FieldColumn<T>(0, buffer), FieldColumn<T>(1, buffer) };
+    }
+
+private:
+    friend class Archetype;
+
+    unsigned char* FieldArray(uint32_t component, int buffer, int field) const {
+        return m_memory->bytes + m_layout->offsets[component][buffer][field];
+    }
+    unsigned char* Cell(uint32_t component, int buffer, int field, uint32_t row) const {
+        return FieldArray(component, buffer, field) + row * TABLE_COMPONENTS[component].FieldSize();
+    }
+    EntityIndex* MutableEntities() { return (EntityIndex*)(m_memory->bytes + m_layout->entityOffset); }
+
+    // 행 값이 바뀜: 모든 버퍼에서 낡은 것으로 보고, 속도로 움직임 여부를 다시 정한다
+    void TouchRow(uint32_t row) {
+        if (m_moving.empty()) return;
+        const uint64_t bit = 1ull << (row % 64);
+        uint64_t& moving = m_moving[row / 64];
+        for (auto& stale : m_stale) stale[row / 64] |= bit;
+        bool moves = false;
+        if (m_layout->mask & MaskOf<PhysicsComponent>()) {
+            const PhysicsColumns vel = Columns<PhysicsComponent>();
+            moves = vel.vx[row] != 0.0 || vel.vy[row] != 0.0;
         }
-        printf("\n");
+        moving = moves ? (moving | bit) : (moving & ~bit);
+    }
+    // 행이 비워짐
+    void ClearRow(uint32_t row) {
+        if (m_moving.empty()) return;
+        const uint64_t keep = ~(1ull << (row % 64));
+        m_moving[row / 64] &= keep;
+        for (auto& stale : m_stale) stale[row / 64] &= keep;
     }
+
+    const ArchetypeLayout* m_layout;
+    std::unique_ptr<ChunkMemory> m_memory;
+    uint32_t m_count = 0;
+    std::vector<uint64_t> m_moving;
+    std::vector<uint64_t> m_stale[TRANSFORM_BUFFERS];
 };
 
-// 전역 동기화 상태 (메인, 물리, 렌더 간의 요청/완료 신호)
-std::mutex g_mutex;
-std::condition_variable g_cv;
-bool g_requestPhysics = false;
-bool g_physicsDone = false;
-bool g_requestRender = false;
-bool g_renderDone = false;
-std::atomic<bool> g_running{ false };
+// Scene::Each 가 한 행씩 넘겨줄 참조를 만드는 도우미.
+// AoS 는 열 원소를 그대로 참조로 넘기고, SoA 는 필드를 임시 구조체에 모았다가 콜백 뒤에 다시 흩어 쓴다.
+template <typename T, bool SoA = IsSoAComponent<T>()>
+class RowAccess {
+public:
+    RowAccess(ArchetypeChunk& chunk, int buffer) : m_column(chunk.Column<T>(buffer)) {}
+    T& Load(uint32_t row) { return m_column[row]; }
+    void Store(uint32_t) {}
+private:
+    T* m_column;
+};
 
-class CPhysicsThread {
+template <typename T>
+class RowAccess<T, true> {
 public:
-    void Run(Scene& scene, EventQueue& events, PhysicsSystem& system) {
-        while (g_running.load()) {
-            // 요청을 기다림
-            {
-                std::unique_lock<std::mutex> lock(g_mutex);
-                g_cv.wait(lock, [] { return !g_running.load() || g_requestPhysics; });
-                if (!g_running.load()) break;
-                g_requestPhysics = false; // consume request
-            }
+    RowAccess(ArchetypeChunk& chunk, int buffer) {
+        for (int f = 0; f < ComponentTraits<T>::Fields; ++f) m_fields[f] = chunk.FieldColumn<T>(f, buffer);
+    }
+    T& Load(uint32_t row) {
+        for (int f = 0; f < ComponentTraits<T>::Fields; ++f) std::memcpy((unsigned char*)&m_value + f * sizeof(double), &m_fields[f][row], sizeof(double));
+        return m_value;
+    }
+    void Store(uint32_t row) {
+        for (int f = 0; f < ComponentTraits<T>::Fields; ++f) std::memcpy(&m_fields[f][row], (const unsigned char*)&m_value + f * sizeof(double), sizeof(double));
+    }
+private:
+    double* m_fields[ComponentTraits<T>::Fields];
+    T m_value;
+};
 
-            // 실제 물리 업데이트
-            system.Update(scene, events);
+// 같은 컴포넌트 조합의 엔티티 행 모음. 행은 항상 빽빽하게 유지된다 (마지막 청크만 덜 찰 수 있음).
+class Archetype {
+public:
+    explicit Archetype(ComponentMask mask) : m_layout(mask) {}
+    Archetype(const Archetype&) = delete;            // 청크가 m_layout 주소를 들고 있으므로 이동 금지
+    Archetype& operator=(const Archetype&) = delete;
 
-            // 버퍼 스왑
-            scene.SwapTransformBuffers();
+    ComponentMask Mask() const { return m_layout.mask; }
+    bool Has(ComponentMask required) const { return (m_layout.mask & required) == required; }
+    bool Matches(ComponentMask required, ComponentMask excluded) const { return Has(required) && !(m_layout.mask & excluded); }
+    uint32_t RowsPerChunk() const { return m_layout.rows; }
 
-            // 완료 신호
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                g_physicsDone = true;
-            }
-            g_cv.notify_all();
+    std::vector<std::unique_ptr<ArchetypeChunk>>& Chunks() { return m_chunks; }
+    const std::vector<std::unique_ptr<ArchetypeChunk>>& Chunks() const { return m_chunks; }
+
+    // 맨 끝에 행을 하나 확보한다 (컴포넌트 값은 호출자가 채움)
+    void Append(EntityIndex e, uint32_t& chunkIndex, uint32_t& row) {
+        if (m_chunks.empty() || m_chunks.back()->m_count == m_layout.rows)
+            m_chunks.push_back(std::make_unique<ArchetypeChunk>(&m_layout));
+        ArchetypeChunk& chunk = *m_chunks.back();
+        chunkIndex = (uint32_t)m_chunks.size() - 1;
+        row = chunk.m_count++;
+        chunk.MutableEntities()[row] = e;
+        chunk.TouchRow(row);
+    }
+
+    // 행을 제거하고 마지막 행을 그 자리로 옮긴다. 옮겨진 엔티티 인덱스를 반환 (없으면 INVALID_ENTITY_INDEX)
+    EntityIndex SwapRemove(uint32_t chunkIndex, uint32_t row) {
+        ArchetypeChunk& last = *m_chunks.back();
+        const uint32_t lastRow = last.m_count - 1;
+        EntityIndex moved = INVALID_ENTITY_INDEX;
+        if (&last != m_chunks[chunkIndex].get() || lastRow != row) {
+            ArchetypeChunk& dst = *m_chunks[chunkIndex];
+            moved = last.Entities()[lastRow];
+            dst.MutableEntities()[row] = moved;
+            ForEachColumn([&](uint32_t c, int b, int f) {
+                std::memcpy(dst.Cell(c, b, f, row), last.Cell(c, b, f, lastRow), TABLE_COMPONENTS[c].FieldSize());
+            });
+            dst.TouchRow(row);
+        }
+        last.ClearRow(lastRow);
+        if (--last.m_count == 0) m_chunks.pop_back();
+        return moved;
+    }
+
+    // 두 아키타입에 공통인 열을 (모든 버퍼에 대해) 복사
+    static void CopyShared(Archetype& from, uint32_t fromChunk, uint32_t fromRow, Archetype& to, uint32_t toChunk, uint32_t toRow) {
+        ArchetypeChunk& src = *from.m_chunks[fromChunk];
+        ArchetypeChunk& dst = *to.m_chunks[toChunk];
+        const ComponentMask shared = from.Mask() & to.Mask();
+        to.ForEachColumn([&](uint32_t c, int b, int f) {
+            if (shared & (1u << c)) std::memcpy(dst.Cell(c, b, f, toRow), src.Cell(c, b, f, fromRow), TABLE_COMPONENTS[c].FieldSize());
+        });
+        dst.TouchRow(toRow);
+    }
+
+    // 한 셀의 모든 버퍼에 같은 값을 쓴다 (SoA 면 필드별로 흩어 쓴다)
+    void Write(uint32_t chunkIndex, uint32_t row, uint32_t component, const void* value) {
+        const ComponentInfo& info = TABLE_COMPONENTS[component];
+        for (int b = 0; b < info.buffers; ++b)
+            for (int f = 0; f < info.fields; ++f)
+                std::memcpy(m_chunks[chunkIndex]->Cell(component, b, f, row), (const unsigned char*)value + f * info.FieldSize(), info.FieldSize());
+        m_chunks[chunkIndex]->TouchRow(row);
+    }
+
+private:
+    template <typename Fn>
+    void ForEachColumn(Fn&& fn) {
+        for (uint32_t c = 0; c < TABLE_COMPONENT_COUNT; ++c) {
+            if (!(m_layout.mask & (1u << c))) continue;
+            for (int b = 0; b < TABLE_COMPONENTS[c].buffers; ++b)
+                for (int f = 0; f < TABLE_COMPONENTS[c].fields; ++f) fn(c, b, f);
         }
     }
+
+    ArchetypeLayout m_layout;
+    std::vector<std::unique_ptr<ArchetypeChunk>> m_chunks;
 };
 
-class CRenderThread {
+// 삼중 버퍼 우편함 (작성자 하나, 독자 하나). 버퍼 3개를 작성자 / 우편함 / 독자가 하나씩 소유하고,
+// 주고받을 때는 우편함과 맞바꾼다. 작성자는 자기 버퍼에만 쓰고 Publish 로 내놓으며,
+// 독자는 AcquireRead 로 가장 최근에 완성된 버퍼를 가져온다. 어느 쪽도 기다리지 않고,
+// 독자가 가진 버퍼에는 다음 AcquireRead 전까지 아무도 쓰지 않는다. 독자가 못 가져간 프레임은 덮어쓴다.
+class TripleBufferMailbox {
 public:
-    void Run(Scene& scene, RenderSystem& system, Renderer& renderer) {
-        std::vector<RenderPacket> packets;
-        while (g_running.load()) {
-            // 렌더 요청 대기
-            {
-                std::unique_lock<std::mutex> lock(g_mutex);
-                g_cv.wait(lock, [] { return !g_running.load() || g_requestRender; });
-                if (!g_running.load()) break;
-                g_requestRender = false; // consume request
-            }
+    // 작성자가 지금 쓰는 버퍼 (작성자 스레드 전용)
+    int WriteIndex() const { return m_write; }
 
-            // 수집 및 그리기
-            system.Collect(scene, packets);
-            renderer.Draw(packets, scene);
+    // 가장 최근에 발행된 버퍼. 작성자는 다음 틱의 원본으로 읽기만 하므로 독자가 들고 있어도 된다.
+    int LatestIndex() const { return m_latest.load(std::memory_order_acquire); }
 
-            // 완료 신호
-            {
-                std::lock_guard<std::mutex> lock(g_mutex);
-                g_renderDone = true;
-            }
-            g_cv.notify_all();
-        }
+    void Publish() {
+        const int written = m_write;
+        m_latest.store(written, std::memory_order_release);
+        m_write = m_mailbox.exchange(written | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // 새 프레임이 있으면 우편함과 맞바꾼다 (독자 스레드 전용)
+    int AcquireRead() {
+        if (m_mailbox.load(std::memory_order_relaxed) & FRESH)
+            m_read = m_mailbox.exchange(m_read, std::memory_order_acq_rel) & INDEX_MASK;
+        return m_read;
     }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;    // 우편함 버퍼가 아직 독자가 가져가지 않은 새 프레임
+
+    alignas(CACHE_LINE) std::atomic<int> m_mailbox{ 1 };
+    alignas(CACHE_LINE) int m_write = 2;
+    std::atomic<int> m_latest{ 0 };
+    alignas(CACHE_LINE) int m_read = 0;
 };
 
-int main() {
-    std::ios_base::sync_with_stdio(false);
+// Transform 버퍼 하나의 버전. seq 가 홀수면 작성자가 쓰는 중이고, 짝수가 될 때 frame 이 그 버퍼의 프레임 번호다.
+struct alignas(CACHE_LINE) BufferVersion {
+    std::atomic<uint64_t> seq{ 0 };
+    std::atomic<uint64_t> frame{ 0 };
+};
 
-    Scene scene;
-    EventQueue events;
-    PhysicsSystem physicsSystem;
-    RenderSystem renderSystem;
-    DamageSystem damageSystem;
-    Renderer renderer;
+// Scene::AcquireSnapshot 이 돌려주는 읽기 가드 (seqlock). 잠금을 잡지 않으므로 독자 수에 제한이 없고 작성자를 막지도 않는다.
+// 다 읽은 뒤 Validate() 로 그동안 작성자가 이 버퍼를 다시 쓰기 시작했는지 확인한다.
+// false 면 읽은 값은 찢어졌을 수 있으니 버리고 다시 AcquireSnapshot 한다.
+// 구조 변경(엔티티 생성/삭제, 컴포넌트 추가/제거, SetTransform)은 보호하지 않는다. 그런 변경은 프레임 사이에만 한다.
+class TransformSnapshot {
+public:
+    int Buffer() const { return m_buffer; }
+    uint64_t Frame() const { return m_frame; }
 
-    // 엔티티 생성
-    Entity player = scene.CreateEntity();
-    scene.GetTransforms_Front()[player] = { 40.0, 12.0 };
-    scene.GetPhysics()[player] = { 0.5, 0.2 };
-    scene.GetRenders()[player] = { '@' };
-    scene.GetHealths()[player] = { 100 };
+    bool Validate() const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_version->seq.load(std::memory_order_relaxed) == m_seq;
+    }
 
-    Entity mob = scene.CreateEntity();
-    scene.GetTransforms_Front()[mob] = { 10.0, 5.0 };
-    scene.GetPhysics()[mob] = { -0.3, 0.1 };
-    scene.GetRenders()[mob] = { 'M' };
-    scene.GetHealths()[mob] = { 50 };
-
-    // 런 스레드 시작 — 병렬 파이프라인 모드
-    std::atomic<bool> running{ true };
-
-    // Physics thread: 고정 타임스텝으로 백버퍼에 바로 쓰고, 완료되면 front 교체(atomic)
-    std::thread tPhysics([&]() {
-        const auto physicsDt = std::chrono::milliseconds(16); // 60Hz
-        while (running.load()) {
-            auto t0 = std::chrono::steady_clock::now();
-            physicsSystem.UpdateParallel(scene, events);
-            auto t1 = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
-            if (elapsed < physicsDt) std::this_thread::sleep_for(physicsDt - elapsed);
-        }
-        });
+private:
+    friend class Scene;
+    TransformSnapshot(const BufferVersion* version, int buffer, uint64_t seq, uint64_t frame)
+        : m_version(version), m_buffer(buffer), m_seq(seq), m_frame(frame) {}
 
-    // Render thread: 가능한 빠르게 front 버퍼를 읽어 그림 (adaptive)
-    std::thread tRender([&]() {
-        std::vector<RenderPacket> packets;
-        while (running.load()) {
-            renderSystem.CollectParallel(scene, packets);
-            renderer.Draw(packets, scene);
-            std::this_thread::sleep_for(std::chrono::milliseconds(16)); // 간단한 VSync 유사 대기
-        }
-        });
+    const BufferVersion* m_version;
+    int m_buffer;
+    uint64_t m_seq;
+    uint64_t m_frame;
+};
 
-    // Main: 이벤트 처리 및 상태 출력
-    const int runSeconds = 10;
-    auto start = std::chrono::steady_clock::now();
-    while (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count() < runSeconds) {
-        // 이벤트 비동기 처리
-        damageSystem.DrainAndApply(scene, events);
-        // 주기적으로 상태 출력(들여다보기용)
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+class Scene {
+public:
+    explicit Scene(EntityIndex initialCapacity = ENTITY_CHUNK_SIZE) {
+        m_archetypeByMask.assign(1u << TABLE_COMPONENT_COUNT, INVALID_ENTITY_INDEX);
+        GetOrCreateArchetype(0); // 컴포넌트가 하나도 없는 엔티티용
+        Reserve(initialCapacity);
     }
 
-    // 종료
-    running.store(false);
-    tPhysics.join();
-    tRender.join();
+    // 용량을 최소 capacity 까지 청크 단위로 늘린다. 기존 슬롯/참조는 그대로 유지된다.
+    // 슬롯별 메타데이터를 모두 늘린 뒤에야 새 용량을 공개(release)하므로,
+    // 다른 스레드는 acquire 로 읽은 Capacity() 범위 안의 슬롯을 항상 안전하게 읽을 수 있다.
+    void Reserve(EntityIndex capacity) {
+        EntityIndex cur = m_capacity.load(std::memory_order_relaxed);
+        if (capacity > MAX_ENTITY_CAPACITY) capacity = MAX_ENTITY_CAPACITY;
+        if (capacity <= cur) return;
 
-    printf("Execution finished.
-        ");
-        return 0;
+        EntityIndex next = cur;
+        while (next < capacity) {
+            m_healths.AddChunk(next);
+            m_locations.AddChunk();   // 새 슬롯은 NO_ARCHETYPE (빈 슬롯)
+            m_generations.AddChunk();
+            next += ENTITY_CHUNK_SIZE;
+        }
+
+        // 빈 슬롯 스택: 뒤에서 꺼내므로 역순으로 넣어 작은 번호부터 배정되게 한다
+        // (새 슬롯은 모두 기존 슬롯보다 번호가 크므로 스택 아래쪽에 깔아둔다)
+        std::vector<EntityIndex> fresh;
+        fresh.reserve(next - cur);
+        for (EntityIndex i = next; i > cur; --i) fresh.push_back(i - 1);
+        m_freeList.insert(m_freeList.begin(), fresh.begin(), fresh.end());
+
+        m_capacity.store(next, std::memory_order_release);
+    }
+
+    EntityIndex Capacity() const { return m_capacity.load(std::memory_order_acquire); }
+
+    // O(1) 생성 (빈 슬롯이 없으면 청크 하나를 늘림). 상한에 도달하면 무효 핸들을 반환
+    // 새 엔티티는 빈 아키타입에 들어가며, Add 로 컴포넌트를 붙일 때마다 해당 아키타입으로 옮겨진다.
+    Entity CreateEntity() {
+        if (m_freeList.empty()) Reserve(Capacity() + ENTITY_CHUNK_SIZE);
+        if (m_freeList.empty()) return Entity{};
+        EntityIndex i = m_freeList.back();
+        m_freeList.pop_back();
+
+        EntityLocation& loc = m_locations[i];
+        loc.archetype = 0;
+        m_archetypes[0]->Append(i, loc.chunk, loc.row);
+        return Entity{ i, m_generations[i] };
+    }
+
+    // O(1) 파괴. 세대를 올려 기존 핸들을 무효화하고 컴포넌트를 제거한 뒤 슬롯을 반납한다.
+    // (시스템 스레드가 순회 중이 아닐 때 호출해야 함)
+    bool DestroyEntity(Entity e) {
+        if (!IsAlive(e)) return false;
+        EntityIndex i = e.index;
+
+        RemoveRow(i);
+        m_locations[i].archetype = NO_ARCHETYPE;
+        ++m_generations[i];
+        m_healths.Remove(i);
+        m_freeList.push_back(i);
+        return true;
+    }
+
+    bool IsAlive(Entity e) const {
+        return e.index < Capacity() && IsActive(e.index) && m_generations[e.index] == e.generation;
+    }
+
+    bool IsActive(EntityIndex i) const { return m_locations[i].archetype != NO_ARCHETYPE; }
+
+    // 살아있는 슬롯 인덱스에 대한 현재 핸들
+    Entity HandleOf(EntityIndex i) const { return Entity{ i, m_generations[i] }; }
+
+    // 위치 설정. 모든 transform 버퍼에 같이 써두므로, 물리가 건드리지 않는(PhysicsComponent 없는)
+    // 엔티티도 버퍼 교체 후 같은 위치를 유지한다.
+    void SetTransform(Entity e, TransformComponent t) { Add(e, t); }
+
+    // 컴포넌트 추가/교체. 테이블 컴포넌트면 아키타입을 옮기고 (모든 버퍼에) 값을 쓴다.
+    // 구조 변경이므로 시스템이 순회 중이 아닐 때만 호출해야 한다.
+    template <typename T>
+    void Add(Entity e, T value) {
+        if (!IsAlive(e)) return;
+        if constexpr (IsTableComponent<T>()) {
+            const uint32_t id = ComponentTraits<T>::Id;
+            ComponentMask mask = m_archetypes[m_locations[e.index].archetype]->Mask() | (1u << id);
+            if constexpr (std::is_same_v<T, PhysicsComponent>)
+                if (value.vx != 0.0 || value.vy != 0.0) mask &= ~MaskOf<SleepingComponent>();   // 움직이기 시작하면 깨운다
+            EntityLocation& loc = MoveToArchetype(e.index, mask);
+            m_archetypes[loc.archetype]->Write(loc.chunk, loc.row, id, &value);
+        }
+        else {
+            Storage<T>().Emplace(e.index, std::move(value));
+        }
+    }
+
+    template <typename T>
+    bool Remove(Entity e) {
+        if (!IsAlive(e)) return false;
+        if constexpr (IsTableComponent<T>()) {
+            const ComponentMask mask = m_archetypes[m_locations[e.index].archetype]->Mask();
+            const ComponentMask bit = 1u << ComponentTraits<T>::Id;
+            if (!(mask & bit)) return false;
+            ComponentMask next = mask & ~bit;
+            if constexpr (std::is_same_v<T, PhysicsComponent>) next &= ~MaskOf<SleepingComponent>();
+            MoveToArchetype(e.index, next);
+            return true;
+        }
+        else {
+            return Storage<T>().Remove(e.index);
+        }
+    }
+
+    // 속도 쓰기. 0 이 아닌 속도는 잠든 엔티티를 깨워 다음 틱부터 물리가 다시 적분한다 (Add 와 같은 구조 변경).
+    // 잠든 엔티티의 속도는 이걸로 바꿔야 한다. Each 로 바꾼 속도는 다음 UpdateSleeping 에서야 깨운다.
+    void SetVelocity(Entity e, PhysicsComponent velocity) { Add(e, velocity); }
+
+    bool IsSleeping(Entity e) const {
+        return IsAlive(e) && (m_archetypes[m_locations[e.index].archetype]->Mask() & MaskOf<SleepingComponent>());
+    }
+
+    // 멈춘(moving 비트가 꺼진) 엔티티를 잠든 아키타입으로 옮기고, Each 로 속도가 생긴 잠든 엔티티를 깨운다.
+    // 재울 때 최신 위치를 모든 transform 버퍼에 써 두므로, 잠든 동안 우편함이 어느 버퍼를 내놓아도 같은 값이다.
+    // 깨어 있는 청크의 비트만 훑으므로 잠든 엔티티는 틱마다 비용이 없다. 구조 변경이므로 프레임 사이에서 호출한다.
+    void UpdateSleeping() {
+        const ComponentMask sleeping = MaskOf<SleepingComponent>();
+        m_sleepMoves.clear();
+        for (auto& arch : m_archetypes) {
+            if (!arch->Has(MaskOf<TransformComponent, PhysicsComponent>())) continue;
+            const bool asleep = (arch->Mask() & sleeping) != 0;
+            if (asleep && !m_sleepersTouched) continue;
+            for (auto& chunk : arch->Chunks()) {
+                const uint32_t n = chunk->Count();
+                const uint64_t* moving = chunk->MovingRows();
+                for (uint32_t w = 0; w < (n + 63) / 64; ++w) {
+                    const uint64_t valid = n - w * 64 >= 64 ? ~0ull : (1ull << (n - w * 64)) - 1;
+                    uint64_t bits = asleep ? moving[w] : ~moving[w] & valid;
+                    for (; bits; bits &= bits - 1) m_sleepMoves.push_back(chunk->Entities()[w * 64 + CountTrailingZeros64(bits)]);
+                }
+            }
+        }
+        m_sleepersTouched = false;
+        // 옮기는 동안 행이 뒤섞이므로 엔티티 인덱스로 모았다가 옮긴다
+        const int front = LoadFrontIndex();
+        for (EntityIndex i : m_sleepMoves) {
+            const bool fallAsleep = !(m_archetypes[m_locations[i].archetype]->Mask() & sleeping);
+            const EntityLocation& loc = MoveToArchetype(i, m_archetypes[m_locations[i].archetype]->Mask() ^ sleeping);
+            if (!fallAsleep) continue;
+            Archetype& arch = *m_archetypes[loc.archetype];
+            const TransformComponent latest = RowAccess<TransformComponent>(*arch.Chunks()[loc.chunk], front).Load(loc.row);
+            arch.Write(loc.chunk, loc.row, ComponentTraits<TransformComponent>::Id, &latest);
+        }
+    }
+
+    // 컴포넌트 포인터 (sparse set 또는 AoS 테이블 컴포넌트). SoA 컴포넌트는 필드가 흩어져 있으므로 Get 을 쓴다.
+    template <typename T>
+    T* TryGet(Entity e) {
+        if (!IsAlive(e)) return nullptr;
+        if constexpr (IsTableComponent<T>()) {
+            static_assert(!IsSoAComponent<T>(), "SoA components have no addressable T; use Get<T>");
+            ArchetypeChunk* chunk = ChunkOf<T>(e.index);
+            return chunk ? chunk->template Column<T>() + m_locations[e.index].row : nullptr;
+        }
+        else {
+            return Storage<T>().TryGet(e.index);
+        }
+    }
+
+    // 테이블 컴포넌트 값 복사본 (다중 버퍼면 가장 최근에 발행된 버퍼)
+    template <typename T>
+    std::optional<T> Get(Entity e) {
+        if (!IsAlive(e)) return std::nullopt;
+        ArchetypeChunk* chunk = ChunkOf<T>(e.index);
+        if (!chunk) return std::nullopt;
+        RowAccess<T> access(*chunk, ComponentTraits<T>::Buffers > 1 ? LoadFrontIndex() : 0);
+        return access.Load(m_locations[e.index].row);
+    }
+
+    // Ts 를 모두 가진 엔티티가 있는 청크마다 fn(ArchetypeChunk&) 호출. 시스템의 핫 루프는 이걸로 열을 직접 훑는다.
+    // excluded 의 컴포넌트(태그) 중 하나라도 가진 아키타입은 건너뛴다
+    template <typename... Ts, typename Fn>
+    void EachChunk(Fn&& fn, ComponentMask excluded = 0) {
+        const ComponentMask required = MaskOf<Ts...>();
+        for (auto& arch : m_archetypes) {
+            if (!arch->Matches(required, excluded)) continue;
+            for (auto& chunk : arch->Chunks()) fn(*chunk);
+        }
+    }
+
+    template <typename... Ts, typename Fn>
+    void EachChunk(Fn&& fn, ComponentMask excluded = 0) const {
+        const ComponentMask required = MaskOf<Ts...>();
+        for (const auto& arch : m_archetypes) {
+            if (!arch->Matches(required, excluded)) continue;
+            for (const auto& chunk : arch->Chunks()) fn(static_cast<const ArchetypeChunk&>(*chunk));
+        }
+    }
+
+    // Ts 를 모두 가진 청크 목록 (병렬 처리에서 인덱스로 나눠 갖기 위함). 다음 구조 변경 전까지만 유효하다.
+    template <typename... Ts>
+    void CollectChunks(std::vector<ArchetypeChunk*>& out, ComponentMask excluded = 0) {
+        out.clear();
+        EachChunk<Ts...>([&](ArchetypeChunk& chunk) { out.push_back(&chunk); }, excluded);
+    }
+
+    template <typename... Ts>
+    void CollectChunks(std::vector<const ArchetypeChunk*>& out, ComponentMask excluded = 0) const {
+        out.clear();
+        EachChunk<Ts...>([&](const ArchetypeChunk& chunk) { out.push_back(&chunk); }, excluded);
+    }
+
+    // Ts 를 모두 가진 엔티티마다 fn(Ts&...) 호출. 다중 버퍼 컴포넌트(Transform)는 가장 최근에 발행된 버퍼를 넘긴다.
+    // SoA 컴포넌트는 행마다 모았다가 다시 쓰므로, 핫 루프는 EachChunk 로 필드 배열을 직접 훑는 편이 낫다.
+    template <typename... Ts, typename Fn>
+    void Each(Fn&& fn) {
+        static_assert((IsTableComponent<Ts>() && ...), "Each only queries table components");
+        const int front = LoadFrontIndex();
+        EachChunk<Ts...>([&](ArchetypeChunk& chunk) {
+            std::tuple<RowAccess<Ts>...> access(RowAccess<Ts>(chunk, ComponentTraits<Ts>::Buffers > 1 ? front : 0)...);
+            const uint32_t n = chunk.Count();
+            for (uint32_t r = 0; r < n; ++r) {
+                fn(std::get<RowAccess<Ts>>(access).Load(r)...);
+                (std::get<RowAccess<Ts>>(access).Store(r), ...);
+            }
+            if constexpr ((MaskOf<Ts...>() & MaskOf<TransformComponent, PhysicsComponent>()) != 0) chunk.TouchAllRows();
+            if constexpr ((MaskOf<Ts...>() & MaskOf<PhysicsComponent>()) != 0)
+                if (chunk.Mask() & MaskOf<SleepingComponent>()) m_sleepersTouched = true;   // 속도가 생겼을 수 있다
+        });
+    }
+
+    // sparse set 에 있는 컴포넌트 저장소
+    template <typename T> SparseSet<T>& Storage() {
+        static_assert(!IsTableComponent<T>(), "table components live in archetype chunks");
+        return std::get<SparseSet<T>&>(StorageRefs());
+    }
+    template <typename T> const SparseSet<T>& Storage() const { return const_cast<Scene*>(this)->Storage<T>(); }
+
+    SparseSet<HealthComponent>& GetHealths() { return m_healths; }
+    const SparseSet<HealthComponent>& GetHealths() const { return m_healths; }
+
+    // Transform 버퍼 인덱스들. 청크의 Columns<TransformComponent>(idx) 로 해당 버퍼에 접근한다.
+    // LoadFrontIndex: 가장 최근에 발행된 버퍼. 작성자의 원본이며, 작성자와 같은 스레드(또는 프레임 사이)에서만
+    //   안전하다. 다른 스레드에서 읽을 거라면 AcquireTransformsForRead (렌더 하나) 나 AcquireSnapshot (여럿) 을 쓴다.
+    int LoadFrontIndex() const { return m_transformMailbox.LatestIndex(); }
+
+    // 작성자(물리) 전용: 이번 틱에 쓸 버퍼를 받아 쓰기 시작을 알리고 (seq 홀수), 다 쓴 뒤 프레임 번호를 붙여 발행한다
+    int BeginTransformWrite() {
+        const int back = m_transformMailbox.WriteIndex();
+        BufferVersion& version = m_transformVersions[back];
+        version.seq.store(version.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);   // 이후의 데이터 쓰기보다 홀수 seq 가 먼저 보이게
+        return back;
+    }
+    void PublishTransforms() {
+        BufferVersion& version = m_transformVersions[m_transformMailbox.WriteIndex()];
+        version.frame.store(++m_transformFrame, std::memory_order_relaxed);
+        version.seq.store(version.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        m_transformMailbox.Publish();
+    }
+    uint64_t TransformFrame(int buffer) const { return m_transformVersions[buffer].frame.load(std::memory_order_acquire); }
+
+    // 아무 스레드에서나, 몇 개의 스레드에서든: 가장 최근에 발행된 버퍼의 읽기 가드
+    TransformSnapshot AcquireSnapshot() const {
+        for (;;) {
+            const int buffer = LoadFrontIndex();
+            const BufferVersion& version = m_transformVersions[buffer];
+            const uint64_t seq = version.seq.load(std::memory_order_acquire);
+            if (seq & 1) continue;   // 그 사이 작성자가 두 번 발행하고 이 버퍼를 다시 쓰는 중: 새 최신 버퍼로
+            return TransformSnapshot(&version, buffer, seq, version.frame.load(std::memory_order_relaxed));
+        }
+    }
+
+    // 일관된 스냅샷을 얻을 때까지 fn(const TransformSnapshot&) 을 다시 실행하고 그 프레임 번호를 반환한다.
+    // fn 은 실패한 시도에서 읽은 값을 버릴 수 있게 작성해야 한다 (예: 출력 버퍼를 처음에 비움).
+    template <typename Fn>
+    uint64_t ReadSnapshot(Fn&& fn) const {
+        for (;;) {
+            const TransformSnapshot snapshot = AcquireSnapshot();
+            fn(snapshot);
+            if (snapshot.Validate()) return snapshot.Frame();
+        }
+    }
+    // 독자(렌더) 전용: 가장 최근에 완성된 버퍼. 다음 호출 전까지 아무도 이 버퍼에 쓰지 않는다.
+    // 우편함의 독자 쪽 소유권만 바뀌고 컴포넌트 데이터는 그대로이므로 const 로 둔다.
+    int AcquireTransformsForRead() const { return m_transformMailbox.AcquireRead(); }
+
+private:
+    std::tuple<SparseSet<HealthComponent>&> StorageRefs() { return { m_healths }; }
+
+    uint32_t GetOrCreateArchetype(ComponentMask mask) {
+        uint32_t& id = m_archetypeByMask[mask];
+        if (id == INVALID_ENTITY_INDEX) {
+            id = (uint32_t)m_archetypes.size();
+            m_archetypes.push_back(std::make_unique<Archetype>(mask));
+        }
+        return id;
+    }
+
+    // 엔티티가 T 를 가지고 있으면 그 행이 있는 청크
+    template <typename T>
+    ArchetypeChunk* ChunkOf(EntityIndex i) {
+        const EntityLocation& loc = m_locations[i];
+        Archetype& arch = *m_archetypes[loc.archetype];
+        return arch.Has(MaskOf<T>()) ? arch.Chunks()[loc.chunk].get() : nullptr;
+    }
+
+    // 행을 빼고, 그 자리로 옮겨진 엔티티의 위치를 고친다
+    void RemoveRow(EntityIndex i) {
+        const EntityLocation loc = m_locations[i];
+        EntityIndex moved = m_archetypes[loc.archetype]->SwapRemove(loc.chunk, loc.row);
+        if (moved != INVALID_ENTITY_INDEX) m_locations[moved] = loc;
+    }
+
+    // 엔티티를 mask 아키타입으로 옮긴다 (공통 컴포넌트는 모든 버퍼 복사)
+    EntityLocation& MoveToArchetype(EntityIndex i, ComponentMask mask) {
+        EntityLocation& loc = m_locations[i];
+        const uint32_t target = GetOrCreateArchetype(mask);
+        if (target == loc.archetype) return loc;
+
+        EntityLocation next;
+        next.archetype = target;
+        m_archetypes[target]->Append(i, next.chunk, next.row);
+        Archetype::CopyShared(*m_archetypes[loc.archetype], loc.chunk, loc.row, *m_archetypes[target], next.chunk, next.row);
+        RemoveRow(i);
+        loc = next;
+        return loc;
+    }
+
+    mutable TripleBufferMailbox m_transformMailbox;
+    BufferVersion m_transformVersions[TRANSFORM_BUFFERS];
+    uint64_t m_transformFrame = 0;             // 작성자 전용: 마지막으로 발행한 프레임 번호
+    std::atomic<EntityIndex> m_capacity{ 0 };
+
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::vector<uint32_t> m_archetypeByMask;   // 테이블 컴포넌트 마스크 -> m_archetypes 인덱스
+    ChunkedArray<EntityLocation> m_locations;  // 엔티티 인덱스 -> 아키타입 내 위치
+    std::vector<EntityIndex> m_sleepMoves;     // UpdateSleeping 이 재우거나 깨울 엔티티 (재사용)
+    bool m_sleepersTouched = false;            // Each 가 잠든 엔티티의 속도를 건드렸을 수 있음
+
+    SparseSet<HealthComponent> m_healths;
+    ChunkedArray<uint32_t> m_generations;
+    std::vector<EntityIndex> m_freeList;
+};
+
+// ---------------------------------------------------------------------------
+// 적분 + 경계 반사 SIMD 커널
+// front(src) 위치에 속도 × dt 를 더해 back(dst)에 쓰고, 움직이는 엔티티가 월드 밖으로 나가면
+// 경계로 되돌리며 해당 축 속도를 뒤집는다. 엔티티마다 어느 벽에 닿았는지 BOUNCE_* 비트를 남기고,
+// 이벤트 생성은 커널 밖에서 그 비트를 훑어 한다. 실행 시 CPU 를 확인해 가장 넓은 구현을 고른다.
+// ---------------------------------------------------------------------------
+
+const double WORLD_MAX_X = 79.0;
+const double WORLD_MAX_Y = 24.0;
+
+enum BounceBits : uint8_t {
+    BOUNCE_MIN_X = 1 << 0,
+    BOUNCE_MAX_X = 1 << 1,
+    BOUNCE_MIN_Y = 1 << 2,
+    BOUNCE_MAX_Y = 1 << 3,
+};
+
+enum class SimdLevel { Scalar, SSE42, AVX2, AVX512 };
+
+inline const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SSE42: return "SSE4.2";
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::AVX512: return "AVX-512";
+    default: return "scalar";
+    }
+}
+
+using IntegrateBounceKernel = void (*)(ConstTransformColumns src, TransformColumns dst, PhysicsColumns vel, uint8_t* bounce, uint32_t n, double dt);
+
+// 모든 구현의 기준 (SIMD 구현과 결과가 비트 단위로 같다). 벽에 닿는 경우가 드물어 그 부분만 분기로 둔다.
+inline void IntegrateBounceScalar(ConstTransformColumns src, TransformColumns dst, PhysicsColumns vel, uint8_t* bounce, uint32_t n, double dt) {
+    for (uint32_t r = 0; r < n; ++r) {
+        double x = src.x[r] + vel.vx[r] * dt, y = src.y[r] + vel.vy[r] * dt;
+        uint8_t bits = 0;
+        if (((x < 0) | (x > WORLD_MAX_X) | (y < 0) | (y > WORLD_MAX_Y)) && (vel.vx[r] != 0.0 || vel.vy[r] != 0.0)) {
+            if (x < 0) { x = 0; bits |= BOUNCE_MIN_X; }
+            else if (x > WORLD_MAX_X) { x = WORLD_MAX_X; bits |= BOUNCE_MAX_X; }
+            if (y < 0) { y = 0; bits |= BOUNCE_MIN_Y; }
+            else if (y > WORLD_MAX_Y) { y = WORLD_MAX_Y; bits |= BOUNCE_MAX_Y; }
+            if (bits & (BOUNCE_MIN_X | BOUNCE_MAX_X)) vel.vx[r] = -vel.vx[r];
+            if (bits & (BOUNCE_MIN_Y | BOUNCE_MAX_Y)) vel.vy[r] = -vel.vy[r];
+        }
+        dst.x[r] = x;
+        dst.y[r] = y;
+        bounce[r] = bits;
+    }
+}
+
+#if THREAD_X86
+
+// 레인별 비교 결과 비트마스크(movemask)를 엔티티별 BOUNCE_* 바이트로 펼친다. 대부분 0 이라 바로 끝난다.
+inline void StoreBounceBits(uint8_t* out, int lanes, unsigned lx, unsigned hx, unsigned ly, unsigned hy) {
+    if ((lx | hx | ly | hy) == 0) {
+        std::memset(out, 0, lanes);
+        return;
+    }
+    for (int k = 0; k < lanes; ++k) {
+        out[k] = (uint8_t)(((lx >> k) & 1) * BOUNCE_MIN_X | ((hx >> k) & 1) * BOUNCE_MAX_X
+            | ((ly >> k) & 1) * BOUNCE_MIN_Y | ((hy >> k) & 1) * BOUNCE_MAX_Y);
+    }
+}
+
+SIMD_TARGET("sse4.2")
+static void IntegrateBounceSSE42(ConstTransformColumns src, TransformColumns dst, PhysicsColumns vel, uint8_t* bounce, uint32_t n, double dt) {
+    const __m128d zero = _mm_setzero_pd(), maxX = _mm_set1_pd(WORLD_MAX_X), maxY = _mm_set1_pd(WORLD_MAX_Y);
+    const __m128d sign = _mm_set1_pd(-0.0), step = _mm_set1_pd(dt);
+    uint32_t r = 0;
+    for (; r + 2 <= n; r += 2) {
+        __m128d vx = _mm_loadu_pd(vel.vx + r), vy = _mm_loadu_pd(vel.vy + r);
+        __m128d x = _mm_add_pd(_mm_loadu_pd(src.x + r), _mm_mul_pd(vx, step)), y = _mm_add_pd(_mm_loadu_pd(src.y + r), _mm_mul_pd(vy, step));
+        const __m128d moving = _mm_or_pd(_mm_cmpneq_pd(vx, zero), _mm_cmpneq_pd(vy, zero));
+        const __m128d lx = _mm_and_pd(_mm_cmplt_pd(x, zero), moving), hx = _mm_and_pd(_mm_cmpgt_pd(x, maxX), moving);
+        const __m128d ly = _mm_and_pd(_mm_cmplt_pd(y, zero), moving), hy = _mm_and_pd(_mm_cmpgt_pd(y, maxY), moving);
+        x = _mm_blendv_pd(_mm_blendv_pd(x, maxX, hx), zero, lx);
+        y = _mm_blendv_pd(_mm_blendv_pd(y, maxY, hy), zero, ly);
+        vx = _mm_xor_pd(vx, _mm_and_pd(_mm_or_pd(lx, hx), sign));
+        vy = _mm_xor_pd(vy, _mm_and_pd(_mm_or_pd(ly, hy), sign));
+        _mm_storeu_pd(dst.x + r, x); _mm_storeu_pd(dst.y + r, y);
+        _mm_storeu_pd(vel.vx + r, vx); _mm_storeu_pd(vel.vy + r, vy);
+        StoreBounceBits(bounce + r, 2, _mm_movemask_pd(lx), _mm_movemask_pd(hx), _mm_movemask_pd(ly), _mm_movemask_pd(hy));
+    }
+    IntegrateBounceScalar({ src.x + r, src.y + r }, { dst.x + r, dst.y + r }, { vel.vx + r, vel.vy + r }, bounce + r, n - r, dt);
+}
+
+SIMD_TARGET("avx2")
+static void IntegrateBounceAVX2(ConstTransformColumns src, TransformColumns dst, PhysicsColumns vel, uint8_t* bounce, uint32_t n, double dt) {
+    const __m256d zero = _mm256_setzero_pd(), maxX = _mm256_set1_pd(WORLD_MAX_X), maxY = _mm256_set1_pd(WORLD_MAX_Y);
+    const __m256d sign = _mm256_set1_pd(-0.0), step = _mm256_set1_pd(dt);
+    uint32_t r = 0;
+    for (; r + 4 <= n; r += 4) {
+        __m256d vx = _mm256_loadu_pd(vel.vx + r), vy = _mm256_loadu_pd(vel.vy + r);
+        __m256d x = _mm256_add_pd(_mm256_loadu_pd(src.x + r), _mm256_mul_pd(vx, step));
+        __m256d y = _mm256_add_pd(_mm256_loadu_pd(src.y + r), _mm256_mul_pd(vy, step));
+        const __m256d moving = _mm256_or_pd(_mm256_cmp_pd(vx, zero, _CMP_NEQ_UQ), _mm256_cmp_pd(vy, zero, _CMP_NEQ_UQ));
+        const __m256d lx = _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ), moving), hx = _mm256_and_pd(_mm256_cmp_pd(x, maxX, _CMP_GT_OQ), moving);
+        const __m256d ly = _mm256_and_pd(_mm256_cmp_pd(y, zero, _CMP_LT_OQ), moving), hy = _mm256_and_pd(_mm256_cmp_pd(y, maxY, _CMP_GT_OQ), moving);
+        x = _mm256_blendv_pd(_mm256_blendv_pd(x, maxX, hx), zero, lx);
+        y = _mm256_blendv_pd(_mm256_blendv_pd(y, maxY, hy), zero, ly);
+        vx = _mm256_xor_pd(vx, _mm256_and_pd(_mm256_or_pd(lx, hx), sign));
+        vy = _mm256_xor_pd(vy, _mm256_and_pd(_mm256_or_pd(ly, hy), sign));
+        _mm256_storeu_pd(dst.x + r, x); _mm256_storeu_pd(dst.y + r, y);
+        _mm256_storeu_pd(vel.vx + r, vx); _mm256_storeu_pd(vel.vy + r, vy);
+        StoreBounceBits(bounce + r, 4, _mm256_movemask_pd(lx), _mm256_movemask_pd(hx), _mm256_movemask_pd(ly), _mm256_movemask_pd(hy));
+    }
+    IntegrateBounceScalar({ src.x + r, src.y + r }, { dst.x + r, dst.y + r }, { vel.vx + r, vel.vy + r }, bounce + r, n - r, dt);
+}
+
+SIMD_TARGET("avx512f")
+static void IntegrateBounceAVX512(ConstTransformColumns src, TransformColumns dst, PhysicsColumns vel, uint8_t* bounce, uint32_t n, double dt) {
+    const __m512d zero = _mm512_setzero_pd(), maxX = _mm512_set1_pd(WORLD_MAX_X), maxY = _mm512_set1_pd(WORLD_MAX_Y);
+    const __m512d minusOne = _mm512_set1_pd(-1.0), step = _mm512_set1_pd(dt);
+    uint32_t r = 0;
+    for (; r + 8 <= n; r += 8) {
+        __m512d vx = _mm512_loadu_pd(vel.vx + r), vy = _mm512_loadu_pd(vel.vy + r);
+        __m512d x = _mm512_add_pd(_mm512_loadu_pd(src.x + r), _mm512_mul_pd(vx, step));
+        __m512d y = _mm512_add_pd(_mm512_loadu_pd(src.y + r), _mm512_mul_pd(vy, step));
+        const __mmask8 moving = _mm512_cmp_pd_mask(vx, zero, _CMP_NEQ_UQ) | _mm512_cmp_pd_mask(vy, zero, _CMP_NEQ_UQ);
+        const __mmask8 lx = _mm512_mask_cmp_pd_mask(moving, x, zero, _CMP_LT_OQ), hx = _mm512_mask_cmp_pd_mask(moving, x, maxX, _CMP_GT_OQ);
+        const __mmask8 ly = _mm512_mask_cmp_pd_mask(moving, y, zero, _CMP_LT_OQ), hy = _mm512_mask_cmp_pd_mask(moving, y, maxY, _CMP_GT_OQ);
+        x = _mm512_mask_blend_pd(lx, _mm512_mask_blend_pd(hx, x, maxX), zero);
+        y = _mm512_mask_blend_pd(ly, _mm512_mask_blend_pd(hy, y, maxY), zero);
+        vx = _mm512_mask_mul_pd(vx, (__mmask8)(lx | hx), vx, minusOne);
+        vy = _mm512_mask_mul_pd(vy, (__mmask8)(ly | hy), vy, minusOne);
+        _mm512_storeu_pd(dst.x + r, x); _mm512_storeu_pd(dst.y + r, y);
+        _mm512_storeu_pd(vel.vx + r, vx); _mm512_storeu_pd(vel.vy + r, vy);
+        StoreBounceBits(bounce + r, 8, lx, hx, ly, hy);
+    }
+    IntegrateBounceScalar({ src.x + r, src.y + r }, { dst.x + r, dst.y + r }, { vel.vx + r, vel.vy + r }, bounce + r, n - r, dt);
+}
+
+#endif // THREAD_X86
+
+// 이 CPU(와 OS 의 레지스터 저장 지원)에서 쓸 수 있는 가장 넓은 SIMD 수준
+inline SimdLevel DetectSimdLevel() {
+#if THREAD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    const int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    const bool sse42 = (regs[2] >> 20) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool avx = (regs[2] >> 28) & 1;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool avx2 = false, avx512 = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        avx2 = (regs[1] >> 5) & 1;
+        avx512 = (regs[1] >> 16) & 1;
+    }
+    if (avx512 && (xcr0 & 0xE6) == 0xE6) return SimdLevel::AVX512;
+    if (avx && avx2 && (xcr0 & 0x6) == 0x6) return SimdLevel::AVX2;
+    if (sse42) return SimdLevel::SSE42;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return SimdLevel::SSE42;
+#endif
+#endif
+    return SimdLevel::Scalar;
+}
+
+inline IntegrateBounceKernel SelectIntegrateKernel(SimdLevel level) {
+#if THREAD_X86
+    switch (level) {
+    case SimdLevel::AVX512: return IntegrateBounceAVX512;
+    case SimdLevel::AVX2: return IntegrateBounceAVX2;
+    case SimdLevel::SSE42: return IntegrateBounceSSE42;
+    default: break;
+    }
+#endif
+    return IntegrateBounceScalar;
+}
+
+// ---------------------------------------------------------------------------
+// 작업 훔치기(work-stealing) 잡 시스템
+// ---------------------------------------------------------------------------
+
+const uint32_t JOB_POOL_SIZE = 4096;        // 작업자별 Job 블록 크기이자 덱 크기 (2의 거듭제곱)
+const uint32_t PARALLEL_FOR_RANGES_PER_WORKER = 16;   // ParallelFor 가 작업자당 만드는 조각 수 상한 (대략)
+const size_t JOB_PAYLOAD_BYTES = 64;
+
+// 한 번 실행되는 작업. 작업자별 풀에서 할당되며 해제하지 않고, unfinished 가 0 인 슬롯만 다시 쓴다.
+// unfinished 는 1 + 자기 자신 + 끝나지 않은 자식 수. 1 이 되면 마지막으로 끝낸 스레드가
+// 0 을 기록한 뒤 부모를 감소시킨다. 0 이 보이면 (Wait 가 반환하면) 그 슬롯은 더 이상 아무도 건드리지 않는다.
+struct alignas(CACHE_LINE) Job {
+    void (*function)(Job& self, unsigned worker);
+    Job* parent;
+    std::atomic<int> unfinished{ 0 };   // 0 = 빈 슬롯
+    alignas(16) unsigned char payload[JOB_PAYLOAD_BYTES];
+};
+
+// Chase-Lev 덱. 주인 작업자만 Push/Pop (bottom 쪽), 다른 작업자는 Steal (top 쪽).
+class WorkStealingDeque {
+public:
+    // 가득 차면 false (호출자가 바로 실행한다)
+    bool Push(Job* job) {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t >= (int64_t)JOB_POOL_SIZE) return false;
+        m_jobs[b & (JOB_POOL_SIZE - 1)].store(job, std::memory_order_relaxed);
+        m_bottom.store(b + 1, std::memory_order_release);   // Steal 의 acquire 와 짝: 작업 내용이 함께 보인다
+        return true;
+    }
+
+    Job* Pop() {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = m_jobs[b & (JOB_POOL_SIZE - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // 마지막 하나: 훔치는 쪽과 top 을 두고 경쟁
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* Steal() {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = m_jobs[t & (JOB_POOL_SIZE - 1)].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return job;
+    }
+
+private:
+    alignas(CACHE_LINE) std::atomic<int64_t> m_top{ 0 };
+    alignas(CACHE_LINE) std::atomic<int64_t> m_bottom{ 0 };
+    alignas(CACHE_LINE) std::atomic<Job*> m_jobs[JOB_POOL_SIZE] = {};
+};
+
+// 작업자마다 덱 하나. 작업을 만든 스레드의 덱에 넣고, 할 일이 없는 작업자는 다른 덱에서 훔친다.
+// 시스템을 만든 스레드가 작업자 0 이며, 작업을 만들고 기다릴 수 있는 건 이 스레드와 작업자 스레드뿐이다.
+// Wait 는 기다리는 동안 다른 작업을 대신 실행하므로 작업 안에서 중첩해 기다려도 된다.
+class JobSystem {
+public:
+    explicit JobSystem(unsigned workers = std::thread::hardware_concurrency())
+        : m_workers(std::max(1u, workers)), m_owner(std::this_thread::get_id()) {
+        for (unsigned w = 1; w < m_workers.size(); ++w)
+            m_threads.emplace_back([this, w] { WorkerLoop(w); });
+    }
+    ~JobSystem() {
+        m_stop.store(true, std::memory_order_release);
+        m_idle.NotifyAll();
+        for (auto& t : m_threads) t.join();
+    }
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 호출 스레드를 포함한 작업자 수 (작업자별 버퍼를 이만큼 둔다)
+    unsigned WorkerCount() const { return (unsigned)m_workers.size(); }
+
+    // fn(unsigned worker) 를 실행할 작업을 만든다 (아직 큐에 넣지 않음). fn 은 참조 캡처 람다 정도의 크기여야 한다.
+    template <typename Fn>
+    Job* Create(Fn&& fn) { return CreateChild(nullptr, std::forward<Fn>(fn)); }
+
+    // parent 는 이 작업이 끝날 때까지 끝나지 않는다
+    template <typename Fn>
+    Job* CreateChild(Job* parent, Fn&& fn) {
+        using F = std::decay_t<Fn>;
+        static_assert(sizeof(F) <= JOB_PAYLOAD_BYTES && alignof(F) <= 16, "job payload too large; capture by reference");
+        static_assert(std::is_trivially_destructible_v<F>, "job payloads are never destroyed");
+        Job* job = Allocate(parent, [](Job& self, unsigned worker) { (*reinterpret_cast<F*>(self.payload))(worker); });
+        new (job->payload) F(std::forward<Fn>(fn));
+        return job;
+    }
+
+    void Run(Job* job) {
+        if (!m_workers[CurrentWorker()].deque.Push(job)) { Execute(*job, CurrentWorker()); return; }
+        WakeWorkers();
+    }
+
+    bool IsDone(const Job* job) const { return job->unfinished.load(std::memory_order_acquire) == 0; }
+
+    // job 이 끝날 때까지 다른 작업을 대신 실행하며 기다린다
+    void Wait(const Job* job) {
+        const unsigned worker = CurrentWorker();
+        while (!IsDone(job)) {
+            if (Job* next = FindJob(worker)) Execute(*next, worker);
+            else std::this_thread::yield();
+        }
+    }
+
+    // [0, count) 를 grain 개 이하의 조각으로 반씩 나눠 fn(begin, end, worker) 로 처리하고, 모두 끝나면 반환한다.
+    // count 가 크면 grain 을 키워 조각 수를 작업자당 PARALLEL_FOR_RANGES_PER_WORKER 개 정도로 묶는다.
+    // 쪼개진 뒤쪽 절반은 덱에 들어가 다른 작업자가 훔쳐 갈 수 있다.
+    template <typename Fn>
+    void ParallelFor(uint32_t count, uint32_t grain, Fn&& fn) {
+        if (count == 0) return;
+        grain = std::max(1u, grain);
+        if (m_threads.empty() || count <= grain) { fn(0u, count, CurrentWorker()); return; }
+        // 조각이 너무 잘면 작업만 늘어난다: 작업자당 PARALLEL_FOR_RANGES_PER_WORKER 개 정도면 훔치기로 고르게 나뉜다
+        const uint32_t ranges = WorkerCount() * PARALLEL_FOR_RANGES_PER_WORKER;
+        grain = std::max(grain, (count + ranges - 1) / ranges);
+        Job* root = CreateRange(nullptr, &fn, 0, count, grain);
+        Run(root);
+        Wait(root);
+    }
+
+private:
+    struct alignas(CACHE_LINE) Worker {
+        WorkStealingDeque deque;
+        std::vector<std::unique_ptr<Job[]>> jobBlocks;   // JOB_POOL_SIZE 개씩. 주인 작업자만 할당하고 늘린다
+        uint32_t nextJob = 0;
+        uint32_t rng = 0x9E3779B9u;
+    };
+
+    struct ThreadBinding { const JobSystem* system; unsigned worker; };
+    static ThreadBinding& Binding() {
+        static thread_local ThreadBinding binding{ nullptr, 0 };
+        return binding;
+    }
+
+    // 작업자 스레드는 시작할 때 등록한다. 등록이 없으면 시스템을 만든 스레드(작업자 0)여야 한다:
+    // 작업자 0 의 덱 Push/Pop 과 작업 풀은 주인 전용이라 다른 스레드가 쓰면 경합한다.
+    unsigned CurrentWorker() const {
+        const ThreadBinding& binding = Binding();
+        if (binding.system == this) return binding.worker;
+        assert(std::this_thread::get_id() == m_owner && "only the creating thread and pool threads may use a JobSystem");
+        return 0;
+    }
+
+    template <typename Fn>
+    struct RangePayload {
+        Fn* fn;
+        JobSystem* system;
+        uint32_t begin, end, grain;
+    };
+
+    template <typename Fn>
+    Job* CreateRange(Job* parent, Fn* fn, uint32_t begin, uint32_t end, uint32_t grain) {
+        Job* job = Allocate(parent, [](Job& self, unsigned worker) {
+            RangePayload<Fn> range = *reinterpret_cast<RangePayload<Fn>*>(self.payload);
+            // 뒤쪽 절반을 자식으로 떼어 내며, 남은 앞쪽이 grain 이하가 되면 직접 처리
+            while (range.end - range.begin > range.grain) {
+                const uint32_t mid = range.begin + (range.end - range.begin) / 2;
+                range.system->Run(range.system->CreateRange(&self, range.fn, mid, range.end, range.grain));
+                range.end = mid;
+            }
+            (*range.fn)(range.begin, range.end, worker);
+        });
+        static_assert(sizeof(RangePayload<Fn>) <= JOB_PAYLOAD_BYTES, "range payload too large");
+        new (job->payload) RangePayload<Fn>{ fn, this, begin, end, grain };
+        return job;
+    }
+
+    // 다음 자리부터 끝난(unfinished == 0) 슬롯을 찾는다. 작업은 대개 만든 순서대로 끝나므로 보통 첫 자리가 비어 있다.
+    // 한 바퀴 돌아도 빈 슬롯이 없으면 (살아 있는 작업이 풀보다 많으면) 블록을 하나 늘린다. 블록은 옮겨지지 않는다.
+    Job* Allocate(Job* parent, void (*function)(Job&, unsigned)) {
+        Worker& w = m_workers[CurrentWorker()];
+        if (w.jobBlocks.empty()) w.jobBlocks.emplace_back(new Job[JOB_POOL_SIZE]);
+        const uint32_t slots = (uint32_t)w.jobBlocks.size() * JOB_POOL_SIZE;
+        Job* job = nullptr;
+        for (uint32_t probe = 0; probe < slots && !job; ++probe) {
+            const uint32_t slot = w.nextJob++ % slots;
+            Job& candidate = w.jobBlocks[slot / JOB_POOL_SIZE][slot % JOB_POOL_SIZE];
+            if (candidate.unfinished.load(std::memory_order_acquire) == 0) job = &candidate;
+        }
+        if (!job) {
+            w.jobBlocks.emplace_back(new Job[JOB_POOL_SIZE]);
+            job = &w.jobBlocks.back()[0];
+            w.nextJob = slots + 1;
+        }
+        job->function = function;
+        job->parent = parent;
+        job->unfinished.store(2, std::memory_order_relaxed);
+        if (parent) parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    void Execute(Job& job, unsigned worker) {
+        job.function(job, worker);
+        Finish(job);
+    }
+
+    void Finish(Job& job) {
+        if (job.unfinished.fetch_sub(1, std::memory_order_acq_rel) != 2) return;
+        Job* const parent = job.parent;
+        job.unfinished.store(0, std::memory_order_release);
+        if (parent) Finish(*parent);
+    }
+
+    // 자기 덱의 최신 작업 먼저, 없으면 임의의 작업자부터 돌아가며 훔친다
+    Job* FindJob(unsigned worker) {
+        Worker& self = m_workers[worker];
+        if (Job* job = self.deque.Pop()) return job;
+        const unsigned count = (unsigned)m_workers.size();
+        self.rng ^= self.rng << 13; self.rng ^= self.rng >> 17; self.rng ^= self.rng << 5;
+        const unsigned start = self.rng % count;
+        for (unsigned k = 0; k < count; ++k) {
+            const unsigned victim = (start + k) % count;
+            if (victim == worker) continue;
+            if (Job* job = m_workers[victim].deque.Steal()) return job;
+        }
+        return nullptr;
+    }
+
+    // 잠든 작업자가 있을 때만 깨운다. 작업자는 잠들겠다고 알린 뒤 덱을 다시 보고 잠들기 때문에 깨우기를 놓치지 않는다.
+    void WakeWorkers() { m_idle.NotifyAll(); }
+
+    void WorkerLoop(unsigned worker) {
+        Binding() = { this, worker };
+        m_workers[worker].rng += worker * 0x85EBCA6Bu;
+        int idle = 0;
+        for (;;) {
+            if (Job* job = FindJob(worker)) { Execute(*job, worker); idle = 0; continue; }
+            if (++idle < 64) { std::this_thread::yield(); continue; }
+
+            const uint32_t key = m_idle.PrepareWait();
+            if (m_stop.load(std::memory_order_acquire)) {
+                m_idle.CancelWait();
+                return;
+            }
+            if (Job* job = FindJob(worker)) {
+                m_idle.CancelWait();
+                Execute(*job, worker);
+            }
+            else {
+                m_idle.Wait(key);
+            }
+            idle = 0;
+        }
+    }
+
+    std::vector<Worker> m_workers;
+    std::vector<std::thread> m_threads;
+    const std::thread::id m_owner;     // 시스템을 만든 스레드 (작업자 0)
+    EventCount m_idle;                 // 할 일이 없어 잠든 작업자
+    std::atomic<bool> m_stop{ false };
+};
+
+// ---------------------------------------------------------------------------
+// 시스템 스케줄러
+// ---------------------------------------------------------------------------
+
+// 컴포넌트가 아닌 공유 상태도 같은 마스크 공간에서 선언한다 (컴포넌트 Id 와 겹치지 않는 윗 비트)
+enum SystemResource : ComponentMask {
+    RESOURCE_RENDER_PACKETS = 1u << 24,  // RenderSystem 이 채우고 Renderer 가 그리는 패킷 목록
+    RESOURCE_CONSOLE = 1u << 25,         // 표준 출력 (화면과 로그가 섞이지 않게)
+};
+
+// 시스템이 한 프레임 동안 무엇을 읽고 쓰는지. 충돌하는 시스템끼리는 등록 순서대로 실행된다.
+struct SystemAccess {
+    ComponentMask reads = 0;
+    ComponentMask writes = 0;
+    ComponentMask snapshotReads = 0;     // 다중 버퍼 컴포넌트의 발행된 버퍼만 읽음: 작성자와 동시에 돌 수 있다
+
+    template <typename... Ts> SystemAccess& Read() { reads |= MaskOf<Ts...>(); return *this; }
+    template <typename... Ts> SystemAccess& Write() { writes |= MaskOf<Ts...>(); return *this; }
+    template <typename... Ts> SystemAccess& ReadSnapshot() {
+        static_assert(((ComponentTraits<Ts>::Buffers > 1) && ...), "only multi-buffered components have published snapshots");
+        snapshotReads |= MaskOf<Ts...>();
+        return *this;
+    }
+    SystemAccess& ReadResource(ComponentMask resources) { reads |= resources; return *this; }
+    SystemAccess& WriteResource(ComponentMask resources) { writes |= resources; return *this; }
+
+    bool ConflictsWith(const SystemAccess& other) const {
+        return (writes & (other.reads | other.writes)) || (other.writes & reads);
+    }
+};
+
+// 등록된 시스템의 접근 선언으로 DAG 를 만들고, 매 프레임 잡 시스템 위에서 실행한다.
+// 먼저 등록된 시스템과 충돌하면 그 시스템이 끝난 뒤에 시작하고, 충돌하지 않는 시스템끼리는 동시에 돈다.
+class SystemScheduler {
+public:
+    explicit SystemScheduler(JobSystem& jobs) : m_jobs(jobs) {}
+
+    void Add(const char* name, const SystemAccess& access, std::function<void()> run) {
+        m_systems.push_back({ name, access, std::move(run), {}, 0 });
+        m_dirty = true;
+    }
+
+    // 한 프레임 실행. 모든 시스템이 끝나면 반환한다.
+    void RunFrame() {
+        if (m_dirty) Build();
+        for (size_t i = 0; i < m_systems.size(); ++i)
+            m_remaining[i].store(m_systems[i].predecessors, std::memory_order_relaxed);
+
+        Job* frame = m_jobs.Create([](unsigned) {});
+        for (uint32_t i = 0; i < (uint32_t)m_systems.size(); ++i)
+            if (m_systems[i].predecessors == 0) m_jobs.Run(CreateSystemJob(frame, i));
+        m_jobs.Run(frame);
+        m_jobs.Wait(frame);
+    }
+
+private:
+    struct SystemNode {
+        const char* name;
+        SystemAccess access;
+        std::function<void()> run;
+        std::vector<uint32_t> successors;   // 이 시스템이 끝나야 시작할 수 있는 시스템
+        int predecessors;
+    };
+
+    // 충돌하는 모든 (앞, 뒤) 쌍에 간선. 간선이 남아도 결과는 같으므로 추이적 축약은 하지 않는다.
+    void Build() {
+        for (auto& system : m_systems) { system.successors.clear(); system.predecessors = 0; }
+        for (uint32_t j = 0; j < (uint32_t)m_systems.size(); ++j) {
+            for (uint32_t i = 0; i < j; ++i) {
+                if (!m_systems[i].access.ConflictsWith(m_systems[j].access)) continue;
+                m_systems[i].successors.push_back(j);
+                ++m_systems[j].predecessors;
+            }
+        }
+        m_remaining.reset(new std::atomic<int>[m_systems.size()]);
+        m_dirty = false;
+    }
+
+    // 시스템을 돌린 뒤 후속 시스템의 남은 선행 수를 줄이고, 0 이 된 것을 같은 프레임의 자식으로 띄운다
+    Job* CreateSystemJob(Job* frame, uint32_t index) {
+        return m_jobs.CreateChild(frame, [this, frame, index](unsigned) {
+            m_systems[index].run();
+            for (uint32_t s : m_systems[index].successors)
+                if (m_remaining[s].fetch_sub(1, std::memory_order_acq_rel) == 1) m_jobs.Run(CreateSystemJob(frame, s));
+        });
+    }
+
+    JobSystem& m_jobs;
+    std::vector<SystemNode> m_systems;
+    std::unique_ptr<std::atomic<int>[]> m_remaining;
+    bool m_dirty = false;
+};
+
+// ---------------------------------------------------------------------------
+// 엔티티끼리의 충돌 (broad-phase)
+// 물체는 Transform+Physics 를 가진 엔티티 (잠든 엔티티 포함), 모양은 반지름 COLLISION_RADIUS 인 원이다.
+// 중심 사이 거리가 지름보다 가까우면 충돌 쌍이다. 이벤트 CollisionEvent{ a, b } 는 접촉이 시작된 틱에만 낸다
+// (붙어 있는 동안 매 틱 내면 닿아 있기만 해도 체력이 틱마다 깎인다). 지난 틱의 정렬된 쌍 키와 비교해 새 쌍만 고른다.
+// ---------------------------------------------------------------------------
+
+const double COLLISION_RADIUS = 0.5;
+const double GRID_CELL_SIZE = 2 * COLLISION_RADIUS;   // 한 칸 = 지름: 충돌 상대는 항상 이웃 3x3 칸 안에 있다
+const uint32_t GRID_COLUMNS = (uint32_t)(WORLD_MAX_X / GRID_CELL_SIZE) + 1;   // 80x25 월드면 80x25 칸
+const uint32_t GRID_ROWS = (uint32_t)(WORLD_MAX_Y / GRID_CELL_SIZE) + 1;
+const uint32_t GRID_CELLS = GRID_COLUMNS * GRID_ROWS;
+
+enum class BroadPhaseMode { None, UniformGrid, SweepAndPrune };
+
+// 항상 a < b 인 정규형으로 만든다 (MakeCollisionPair). 같은 쌍은 어느 쪽에서 찾아도 같은 값이다.
+struct CollisionPair { EntityIndex a, b; };
+
+inline CollisionPair MakeCollisionPair(EntityIndex a, EntityIndex b) { return a < b ? CollisionPair{ a, b } : CollisionPair{ b, a }; }
+// 엔티티 인덱스는 MAX_ENTITY_CAPACITY(2^24) 미만이므로 쌍 하나가 48비트 키에 들어간다
+const int COLLISION_PAIR_KEY_BITS = 48;
+static_assert(MAX_ENTITY_CAPACITY <= (1u << (COLLISION_PAIR_KEY_BITS / 2)), "entity index must fit half a pair key");
+inline uint64_t CollisionPairKey(CollisionPair pair) { return (uint64_t)pair.a << (COLLISION_PAIR_KEY_BITS / 2) | pair.b; }
+inline CollisionPair CollisionPairFromKey(uint64_t key) {
+    const uint64_t low = (1ull << (COLLISION_PAIR_KEY_BITS / 2)) - 1;
+    return { (EntityIndex)(key >> (COLLISION_PAIR_KEY_BITS / 2)), (EntityIndex)(key & low) };
+}
+
+// 작업자별 쌍 버퍼 (broad-phase 가 찾은 쌍).
+struct alignas(CACHE_LINE) WorkerPairs {
+    std::vector<CollisionPair> pairs;
+};
+
+// 이번 틱의 충돌 검사 대상. 청크 순서대로 필드별 배열에 모은다.
+struct CollisionBodies {
+    std::vector<double> x, y;
+    std::vector<EntityIndex> owners;
+    uint32_t Count() const { return (uint32_t)owners.size(); }
+};
+
+inline bool BodiesOverlap(double ax, double ay, double bx, double by) {
+    const double dx = ax - bx, dy = ay - by;
+    return dx * dx + dy * dy < GRID_CELL_SIZE * GRID_CELL_SIZE;
+}
+
+// 아래쪽 keyBits 비트만 쓰는 키의 LSD 기수 정렬 (8비트 자리씩, 안정). 모든 키가 같은 값을 가진 자리는 건너뛴다
+// (엔티티가 수천 개면 쌍 키 6자리 중 4자리만 돈다). 자리마다 개수를 한 번에 세어 두고 자리마다 흩어 쓴다.
+// 자리를 넓히면 흩어 쓸 곳이 많아져 캐시에서 밀려나므로 8비트가 가장 빨랐다. 결과는 keys 에 남는다.
+const int RADIX_DIGIT_BITS = 8;
+inline void RadixSortKeys(std::vector<uint64_t>& keys, std::vector<uint64_t>& temp, int keyBits) {
+    const size_t n = keys.size();
+    if (n < 2) return;
+    const int digits = (keyBits + RADIX_DIGIT_BITS - 1) / RADIX_DIGIT_BITS;
+    const uint64_t digitMask = (1u << RADIX_DIGIT_BITS) - 1;
+    std::vector<uint32_t> counts((size_t)digits << RADIX_DIGIT_BITS, 0);
+    for (uint64_t key : keys)
+        for (int d = 0; d < digits; ++d) ++counts[((size_t)d << RADIX_DIGIT_BITS) + ((key >> (d * RADIX_DIGIT_BITS)) & digitMask)];
+    temp.resize(n);
+    for (int d = 0; d < digits; ++d) {
+        uint32_t* count = &counts[(size_t)d << RADIX_DIGIT_BITS];
+        if (count[(keys[0] >> (d * RADIX_DIGIT_BITS)) & digitMask] == n) continue;
+        uint32_t offset = 0;
+        for (uint32_t v = 0; v <= digitMask; ++v) { const uint32_t c = count[v]; count[v] = offset; offset += c; }
+        for (uint64_t key : keys) temp[count[(key >> (d * RADIX_DIGIT_BITS)) & digitMask]++] = key;
+        keys.swap(temp);
+    }
+}
+
+// 작업자별 쌍 버퍼를 키 하나로 모아 기수 정렬하고 중복을 없앤다. 여러 작업자가 같은 쌍을 찾아도 한 번만 남고,
+// 결과는 (a, b) 오름차순이라 작업자 수나 작업 분배와 상관없이 같다.
+inline void MergeCollisionPairs(const std::vector<WorkerPairs>& perWorker, std::vector<uint64_t>& keys, std::vector<uint64_t>& temp) {
+    keys.clear();
+    for (const WorkerPairs& worker : perWorker)
+        for (const CollisionPair& pair : worker.pairs) keys.push_back(CollisionPairKey(pair));
+    RadixSortKeys(keys, temp, COLLISION_PAIR_KEY_BITS);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+// 균일 격자. 매 틱 물체를 칸별로 계수 정렬해 다시 담고, 칸마다 자기 칸과 앞쪽 이웃 4칸만 검사한다
+// (뒤쪽 이웃은 그 칸 차례에 이 칸을 본다: 같은 쌍을 두 번 보지 않음). 밀도가 고르면 기대 O(N).
+// 정렬은 물체를 고정 크기 블록으로 나눠 블록별 개수 → 칸·블록 순 시작 위치 → 흩어 쓰기 순서로 병렬화하며,
+// 블록이 물체 순서대로이므로 칸 안의 순서는 블록 수(작업자 수)와 상관없이 물체 순서다.
+// 블록마다 칸 수만큼의 개수 배열을 비우고 훑으므로, 블록 수는 물체 수에 맞춰 줄인다 (물체가 적으면 블록 하나로 직렬).
+class UniformGridBroadPhase {
+public:
+    explicit UniformGridBroadPhase(JobSystem& jobs)
+        : m_jobs(jobs), m_maxBlocks(jobs.WorkerCount() * 4), m_cellStart(GRID_CELLS + 1) {}
+
+    // 충돌 쌍(정규형)을 out[worker] 에 덧붙인다. 작업자별 나뉨과 순서는 실행마다 다를 수 있다.
+    void FindPairs(const CollisionBodies& bodies, std::vector<WorkerPairs>& out) {
+        const uint32_t n = bodies.Count();
+        if (n == 0) return;
+        m_blocks = std::min(m_maxBlocks, (n + GRID_MIN_BLOCK_BODIES - 1) / GRID_MIN_BLOCK_BODIES);
+        const uint32_t blockSize = (n + m_blocks - 1) / m_blocks;
+        m_cellOf.resize(n);
+        m_blockCursor.assign((size_t)m_blocks * GRID_CELLS, 0);
+
+        // 1) 블록마다 칸 번호와 칸별 개수
+        m_jobs.ParallelFor(m_blocks, 1, [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t k = begin; k < end; ++k) {
+                uint32_t* counts = &m_blockCursor[(size_t)k * GRID_CELLS];
+                for (uint32_t i = k * blockSize; i < std::min(n, (k + 1) * blockSize); ++i) {
+                    m_cellOf[i] = CellOf(bodies.x[i], bodies.y[i]);
+                    ++counts[m_cellOf[i]];
+                }
+            }
+        });
+
+        // 2) 칸 순서, 칸 안에서는 블록 순서로 시작 위치를 매긴다 (개수를 그 자리에서 쓰기 위치로 바꿈)
+        uint32_t offset = 0;
+        for (uint32_t c = 0; c < GRID_CELLS; ++c) {
+            m_cellStart[c] = offset;
+            for (uint32_t k = 0; k < m_blocks; ++k) {
+                uint32_t& cursor = m_blockCursor[(size_t)k * GRID_CELLS + c];
+                const uint32_t count = cursor;
+                cursor = offset;
+                offset += count;
+            }
+        }
+        m_cellStart[GRID_CELLS] = offset;
+
+        // 3) 흩어 쓰기: 칸별로 연속된 물체 배열
+        m_x.resize(n); m_y.resize(n); m_owners.resize(n);
+        m_jobs.ParallelFor(m_blocks, 1, [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t k = begin; k < end; ++k) {
+                uint32_t* cursor = &m_blockCursor[(size_t)k * GRID_CELLS];
+                for (uint32_t i = k * blockSize; i < std::min(n, (k + 1) * blockSize); ++i) {
+                    const uint32_t dst = cursor[m_cellOf[i]]++;
+                    m_x[dst] = bodies.x[i];
+                    m_y[dst] = bodies.y[i];
+                    m_owners[dst] = bodies.owners[i];
+                }
+            }
+        });
+
+        // 4) 칸 한 줄씩 나눠 검사
+        m_jobs.ParallelFor(GRID_CELLS, GRID_COLUMNS, [&](uint32_t begin, uint32_t end, unsigned worker) {
+            for (uint32_t c = begin; c < end; ++c) TestCell(c, out[worker].pairs);
+        });
+    }
+
+private:
+    static constexpr uint32_t GRID_MIN_BLOCK_BODIES = 1024;   // 블록 하나가 맡는 최소 물체 수
+
+    static uint32_t CellOf(double x, double y) {
+        const uint32_t cx = (uint32_t)std::clamp(x / GRID_CELL_SIZE, 0.0, (double)(GRID_COLUMNS - 1));
+        const uint32_t cy = (uint32_t)std::clamp(y / GRID_CELL_SIZE, 0.0, (double)(GRID_ROWS - 1));
+        return cy * GRID_COLUMNS + cx;
+    }
+
+    void TestCell(uint32_t cell, std::vector<CollisionPair>& out) const {
+        const uint32_t begin = m_cellStart[cell], end = m_cellStart[cell + 1];
+        if (begin == end) return;
+        const int cx = (int)(cell % GRID_COLUMNS), cy = (int)(cell / GRID_COLUMNS);
+        // 자기 칸: 뒤쪽 물체와만
+        for (uint32_t i = begin; i < end; ++i)
+            for (uint32_t j = i + 1; j < end; ++j) TestPair(i, j, out);
+        // 앞쪽 이웃: 오른쪽, 아래 줄의 왼쪽/가운데/오른쪽
+        static const int NEIGHBORS[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+        for (const auto& d : NEIGHBORS) {
+            const int nx = cx + d[0], ny = cy + d[1];
+            if (nx < 0 || nx >= (int)GRID_COLUMNS || ny >= (int)GRID_ROWS) continue;
+            const uint32_t other = (uint32_t)ny * GRID_COLUMNS + (uint32_t)nx;
+            for (uint32_t i = begin; i < end; ++i)
+                for (uint32_t j = m_cellStart[other]; j < m_cellStart[other + 1]; ++j) TestPair(i, j, out);
+        }
+    }
+
+    void TestPair(uint32_t i, uint32_t j, std::vector<CollisionPair>& out) const {
+        if (BodiesOverlap(m_x[i], m_y[i], m_x[j], m_y[j])) out.push_back(MakeCollisionPair(m_owners[i], m_owners[j]));
+    }
+
+    JobSystem& m_jobs;
+    uint32_t m_maxBlocks;                   // 정렬 블록 수 상한 (작업자 수에 비례)
+    uint32_t m_blocks = 1;                  // 이번 틱의 정렬 블록 수
+    std::vector<uint32_t> m_cellOf;         // 물체별 칸 번호 (입력 순서)
+    std::vector<uint32_t> m_blockCursor;    // [블록][칸] 개수, 이어서 쓰기 위치
+    std::vector<uint32_t> m_cellStart;      // 칸 c 의 물체는 [m_cellStart[c], m_cellStart[c + 1])
+    std::vector<double> m_x, m_y;           // 칸 순서로 정렬된 물체
+    std::vector<EntityIndex> m_owners;
+};
+
+// 정렬 후 훑기 (sort and sweep). 물체를 x 로 정렬해 두고, 각 물체에서 x 거리가 지름 안인 뒤쪽 물체만 검사한다.
+// 정렬된 순서를 틱 사이에 유지하므로 (한 틱에 조금씩만 움직임) 다음 틱에는 삽입 정렬로 거의 선형에 맞춘다.
+// 칸 크기에 묶이지 않아 밀도가 고르지 않을 때 격자 대신 쓴다.
+class SweepAndPruneBroadPhase {
+public:
+    explicit SweepAndPruneBroadPhase(JobSystem& jobs) : m_jobs(jobs) {}
+
+    // 충돌 쌍(정규형)을 out[worker] 에 덧붙인다. 작업자별 나뉨과 순서는 실행마다 다를 수 있다.
+    void FindPairs(const CollisionBodies& bodies, std::vector<WorkerPairs>& out) {
+        const uint32_t n = bodies.Count();
+        ++m_tick;
+
+        // 이번 틱의 물체를 엔티티 인덱스로 찾을 수 있게 표시
+        EntityIndex maxOwner = 0;
+        for (uint32_t i = 0; i < n; ++i) maxOwner = std::max(maxOwner, bodies.owners[i]);
+        if (m_bodyOf.size() <= maxOwner) { m_bodyOf.resize(maxOwner + 1); m_bodyTick.resize(maxOwner + 1, 0); m_keptTick.resize(maxOwner + 1, 0); }
+        for (uint32_t i = 0; i < n; ++i) { m_bodyOf[bodies.owners[i]] = i; m_bodyTick[bodies.owners[i]] = m_tick; }
+
+        // 지난 틱 순서에서 사라진 물체는 빼고 위치만 새로 읽는다
+        uint32_t kept = 0;
+        for (const SweepEntry& entry : m_entries) {
+            const EntityIndex owner = entry.owner;
+            if (owner >= m_bodyTick.size() || m_bodyTick[owner] != m_tick) continue;
+            const uint32_t body = m_bodyOf[owner];
+            m_entries[kept++] = { bodies.x[body], bodies.y[body], owner };
+            m_keptTick[owner] = m_tick;
+        }
+        m_entries.resize(kept);
+
+        // 거의 정렬된 앞부분은 삽입 정렬, 새로 들어온 물체는 따로 정렬해 합친다
+        if (!InsertionSortByX(m_entries.begin(), m_entries.end(), SWEEP_MAX_SHIFTS_PER_BODY * (size_t)kept))
+            std::sort(m_entries.begin(), m_entries.end(), LessX);
+        for (uint32_t i = 0; i < n; ++i)
+            if (m_keptTick[bodies.owners[i]] != m_tick) m_entries.push_back({ bodies.x[i], bodies.y[i], bodies.owners[i] });
+        if (m_entries.size() > kept) {
+            std::sort(m_entries.begin() + kept, m_entries.end(), LessX);
+            std::inplace_merge(m_entries.begin(), m_entries.begin() + kept, m_entries.end(), LessX);
+        }
+
+        // 훑기: 물체마다 독립이므로 나눠서
+        m_jobs.ParallelFor(n, SWEEP_GRAIN, [&](uint32_t begin, uint32_t end, unsigned worker) {
+            std::vector<CollisionPair>& pairs = out[worker].pairs;
+            for (uint32_t i = begin; i < end; ++i) {
+                const SweepEntry& a = m_entries[i];
+                for (uint32_t j = i + 1; j < n && m_entries[j].x - a.x < GRID_CELL_SIZE; ++j) {
+                    const SweepEntry& b = m_entries[j];
+                    if (BodiesOverlap(a.x, a.y, b.x, b.y)) pairs.push_back(MakeCollisionPair(a.owner, b.owner));
+                }
+            }
+        });
+    }
+
+private:
+    struct SweepEntry { double x, y; EntityIndex owner; };
+
+    static constexpr size_t SWEEP_MAX_SHIFTS_PER_BODY = 16;   // 이보다 많이 밀리면 (순간이동 등) 일반 정렬로
+    static constexpr uint32_t SWEEP_GRAIN = 1024;
+
+    static bool LessX(const SweepEntry& a, const SweepEntry& b) { return a.x < b.x; }
+
+    // 밀어낸 횟수가 budget 을 넘으면 멈추고 false (이미 옮긴 원소는 그대로 둔다: 순열은 유지됨)
+    template <typename It>
+    static bool InsertionSortByX(It first, It last, size_t budget) {
+        size_t shifts = 0;
+        for (It i = first + (first != last); i < last; ++i) {
+            const SweepEntry entry = *i;
+            It j = i;
+            for (; j > first && (j - 1)->x > entry.x; --j) {
+                *j = *(j - 1);
+                if (++shifts > budget) { *(j - 1) = entry; return false; }
+            }
+            *j = entry;
+        }
+        return true;
+    }
+
+    JobSystem& m_jobs;
+    std::vector<SweepEntry> m_entries;      // x 순서 (다음 틱 삽입 정렬의 출발점)
+    std::vector<uint32_t> m_bodyOf;         // 엔티티 인덱스 -> 이번 틱 물체 번호
+    std::vector<uint32_t> m_bodyTick;       // 엔티티 인덱스 -> 마지막으로 물체였던 틱
+    std::vector<uint32_t> m_keptTick;       // 엔티티 인덱스 -> 지난 순서에서 이어받은 틱
+    uint32_t m_tick = 0;
+};
+
+// 델타 복사는 캐시 라인 하나(double 8개) 단위로 처리하고, 이만큼 이하로 떨어진 라인 구간은 하나로 합친다
+const uint32_t DELTA_LINE_ROWS = (uint32_t)(CACHE_LINE / sizeof(double));
+const uint32_t DELTA_GAP_LINES = 2;
+
+// 행 비트 64개(라인 8개)를 라인 비트 8개로: 바이트마다 하나라도 켜져 있으면 그 라인 비트를 켠다
+inline uint64_t RowBitsToLineBits(uint64_t rows) {
+    rows |= rows >> 4;
+    rows |= rows >> 2;
+    rows |= rows >> 1;
+    return ((rows & 0x0101010101010101ull) * 0x0102040810204080ull) >> 56;
+}
+
+class PhysicsSystem {
+public:
+    explicit PhysicsSystem(JobSystem& jobs)
+        : m_jobs(jobs), m_scratch(jobs.WorkerCount()), m_pairs(jobs.WorkerCount()), m_grid(jobs), m_sweep(jobs) {
+        SetSimdLevel(DetectSimdLevel());
+    }
+
+    // Transform 은 작성자 몫의 버퍼에 쓰고 발행한다. 충돌은 CollisionEvent 채널로만 나간다.
+    static SystemAccess Access() { return SystemAccess().Write<TransformComponent, PhysicsComponent>(); }
+
+    // 커널 수준 고정 (벤치마크/비교용). CPU 가 지원하는 수준보다 높게는 올라가지 않는다.
+    void SetSimdLevel(SimdLevel level) {
+        const SimdLevel supported = DetectSimdLevel();
+        m_simdLevel = (int)level > (int)supported ? supported : level;
+        m_kernel = SelectIntegrateKernel(m_simdLevel);
+    }
+    SimdLevel GetSimdLevel() const { return m_simdLevel; }
+
+    // 변경된 행만 쓰기 (기본값). 끄면 매 틱 모든 행을 원본에서 다시 계산한다 (벤치마크 비교용).
+    void SetDeltaCopy(bool enabled) { m_deltaCopy = enabled; }
+
+    // 엔티티끼리 충돌 검사 방식 (None 이면 벽 충돌만). 밀도가 고르면 격자, 몰려 있으면 정렬 후 훑기.
+    void SetBroadPhase(BroadPhaseMode mode) { m_broadPhase = mode; }
+
+    // 병렬 파이프라인용 Update: 최근 발행된 버퍼를 읽어 작성자 몫의 버퍼에 쓰고, 완료 시 우편함으로 발행
+    // Transform+Physics 아키타입의 청크만 순회한다. 나머지 엔티티는 SetTransform 으로 모든 버퍼가 같게 유지된다.
+    // 잠든 아키타입은 아예 건너뛴다 (UpdateSleeping 이 모든 버퍼가 같아진 뒤에만 재우므로 쓸 것이 없다).
+    // 청크 단위로 잡 시스템에 나눠 주며, 청크끼리는 쓰는 곳이 겹치지 않으므로 잠금이 필요 없다.
+    // dt 는 초 단위 고정 스텝 (속도는 초당 거리). 고정 스텝 누산은 FixedTimestep 이 한다.
+    void UpdateParallel(Scene& scene, GameEvents& events, double dt) {
+        // 원본은 지난 틱에 발행한 버퍼 (렌더가 들고 있을 수도 있지만 읽기만 한다)
+        const int curFront = scene.LoadFrontIndex();
+        const int back = scene.BeginTransformWrite();
+
+        // 이번 틱의 충돌 이벤트는 작업자별 배치에 모았다가 틱 끝에 정해진 순서로 넘긴다
+        for (auto& scratch : m_scratch) { scratch.events.clear(); scratch.segments.clear(); }
+
+        scene.CollectChunks<TransformComponent, PhysicsComponent>(m_chunks, MaskOf<SleepingComponent>());
+        m_jobs.ParallelFor((uint32_t)m_chunks.size(), 1, [&](uint32_t begin, uint32_t end, unsigned worker) {
+            WorkerScratch& scratch = m_scratch[worker];
+            const uint32_t firstEvent = (uint32_t)scratch.events.size();
+            for (uint32_t c = begin; c < end; ++c) {
+                ArchetypeChunk& chunk = *m_chunks[c];
+                const ConstTransformColumns src = chunk.Columns<TransformComponent>(curFront);
+                const TransformColumns dst = chunk.Columns<TransformComponent>(back);
+                const PhysicsColumns vel = chunk.Columns<PhysicsComponent>();
+                const uint32_t n = chunk.Count();
+                scratch.bounce.resize(n);
+
+                // 적분 + 경계 반사 (SIMD), 벽 충돌은 엔티티별 비트로만 남긴다. 비트가 켜진 엔티티에 대해서만 이벤트 생성.
+                auto integrate = [&](uint32_t from, uint32_t to) {
+                    m_kernel({ src.x + from, src.y + from }, { dst.x + from, dst.y + from }, { vel.vx + from, vel.vy + from },
+                        scratch.bounce.data() + from, to - from, dt);
+                    EmitBounceEvents(scene, chunk.Entities() + from, scratch.bounce.data() + from, to - from, scratch.events);
+                };
+
+                if (m_deltaCopy) {
+                    // 움직이는 행과 이 버퍼에서 낡은 행이 있는 캐시 라인(double 8개)만. 나머지 라인은 읽지도 쓰지도 않는다.
+                    // 라인 안의 멈춘 최신 행은 다시 계산해도 값이 같다. 행 단위로 구간을 나누면 무작위로 섞인 장면에서
+                    // 구간이 너무 잘게 쪼개지고, 라인 단위면 SIMD 로드도 라인을 걸치지 않는다.
+                    const uint32_t lines = (n + DELTA_LINE_ROWS - 1) / DELTA_LINE_ROWS;
+                    scratch.lines.assign((lines + 63) / 64, 0);
+                    const uint64_t* moving = chunk.MovingRows();
+                    const uint64_t* stale = chunk.StaleRows(back);
+                    size_t dirtyLines = 0;
+                    for (uint32_t w = 0; w < (n + 63) / 64; ++w) {
+                        const uint64_t lineBits = RowBitsToLineBits(moving[w] | stale[w]);
+                        scratch.lines[w / 8] |= lineBits << ((w % 8) * 8);
+                        dirtyLines += std::bitset<8>(lineBits).count();
+                    }
+                    if (dirtyLines == 0) { chunk.CommitTransformWrite(back); continue; }
+                    if (dirtyLines == lines) { integrate(0, n); chunk.CommitTransformWrite(back); continue; }
+                    // 짧은 틈은 메워 한 구간으로 (커널 호출이 줄어든다)
+                    uint32_t runBegin = 0, runEnd = 0;
+                    auto flush = [&] { integrate(runBegin * DELTA_LINE_ROWS, std::min(n, runEnd * DELTA_LINE_ROWS)); };
+                    ForEachBitRun(scratch.lines.data(), lines, [&](uint32_t from, uint32_t to) {
+                        if (runEnd > runBegin && from - runEnd > DELTA_GAP_LINES) { flush(); runBegin = from; }
+                        else if (runEnd == runBegin) runBegin = from;
+                        runEnd = to;
+                    });
+                    if (runEnd > runBegin) flush();
+                } else {
+                    integrate(0, n);
+                }
+                chunk.CommitTransformWrite(back);
+            }
+            scratch.segments.push_back({ begin, (uint32_t)worker, firstEvent, (uint32_t)scratch.events.size() });
+        });
+
+        // 적분이 끝난 위치(back)로 엔티티끼리 충돌. 발행 전이므로 back 은 아직 이 스레드 몫이다.
+        if (m_broadPhase != BroadPhaseMode::None) {
+            GatherBodies(scene, back);
+            for (auto& worker : m_pairs) worker.pairs.clear();
+            if (m_broadPhase == BroadPhaseMode::UniformGrid) m_grid.FindPairs(m_bodies, m_pairs);
+            else m_sweep.FindPairs(m_bodies, m_pairs);
+            MergeCollisionPairs(m_pairs, m_pairKeys, m_pairKeysTemp);
+            // 둘 다 정렬돼 있으므로 차집합이 곧 이번 틱에 새로 닿은 쌍 (역시 정렬된 순서)
+            m_startedKeys.clear();
+            std::set_difference(m_pairKeys.begin(), m_pairKeys.end(), m_contactKeys.begin(), m_contactKeys.end(),
+                std::back_inserter(m_startedKeys));
+            m_contactKeys.swap(m_pairKeys);
+        } else {
+            m_contactKeys.clear();
+        }
+
+        // ParallelFor 가 반환했으면 모든 조각의 쓰기가 끝난 것. 우편함에 발행 (release)
+        scene.PublishTransforms();
+
+        // 큐와의 동기화는 틱마다 한 번. 작업자 수와 상관없이 같은 내용, 같은 순서가 되도록
+        // 벽 충돌은 청크 순서로 (조각을 첫 청크 순으로 이어 붙임), 새로 닿은 엔티티 쌍은 정렬된 키 순서로 넣는다.
+        m_segments.clear();
+        for (const auto& scratch : m_scratch) m_segments.insert(m_segments.end(), scratch.segments.begin(), scratch.segments.end());
+        std::sort(m_segments.begin(), m_segments.end(), [](const EventSegment& a, const EventSegment& b) { return a.firstChunk < b.firstChunk; });
+        m_tickEvents.clear();
+        for (const EventSegment& segment : m_segments) {
+            const std::vector<CollisionEvent>& source = m_scratch[segment.worker].events;
+            m_tickEvents.insert(m_tickEvents.end(), source.begin() + segment.begin, source.begin() + segment.end);
+        }
+        if (m_broadPhase != BroadPhaseMode::None) {
+            for (uint64_t key : m_startedKeys) {
+                const CollisionPair pair = CollisionPairFromKey(key);
+                m_tickEvents.push_back(CollisionEvent{ scene.HandleOf(pair.a), scene.HandleOf(pair.b) });
+            }
+        }
+        if (!m_tickEvents.empty()) events.Channel<CollisionEvent>().PushBatch(m_tickEvents);
+    }
+
+    // 충돌 대상(잠든 엔티티 포함)의 buffer 위치를 청크 순서대로 모은다. 청크마다 들어갈 자리를 먼저 정하고 나눠 복사.
+    void GatherBodies(Scene& scene, int buffer) {
+        scene.CollectChunks<TransformComponent, PhysicsComponent>(m_bodyChunks);
+        m_bodyOffsets.resize(m_bodyChunks.size() + 1);
+        uint32_t total = 0;
+        for (size_t c = 0; c < m_bodyChunks.size(); ++c) { m_bodyOffsets[c] = total; total += m_bodyChunks[c]->Count(); }
+        m_bodyOffsets[m_bodyChunks.size()] = total;
+        m_bodies.x.resize(total); m_bodies.y.resize(total); m_bodies.owners.resize(total);
+
+        m_jobs.ParallelFor((uint32_t)m_bodyChunks.size(), 1, [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t c = begin; c < end; ++c) {
+                const ArchetypeChunk& chunk = *m_bodyChunks[c];
+                const ConstTransformColumns pos = chunk.Columns<TransformComponent>(buffer);
+                const uint32_t n = chunk.Count(), at = m_bodyOffsets[c];
+                std::memcpy(&m_bodies.x[at], pos.x, n * sizeof(double));
+                std::memcpy(&m_bodies.y[at], pos.y, n * sizeof(double));
+                std::memcpy(&m_bodies.owners[at], chunk.Entities(), n * sizeof(EntityIndex));
+            }
+        });
+    }
+
+    // 벽마다 이벤트 하나 (x 최소, x 최대, y 최소, y 최대 순). 8 엔티티씩 한 번에 건너뛴다.
+    static void EmitBounceEvents(const Scene& scene, const EntityIndex* owners, const uint8_t* bounce, uint32_t n,
+        std::vector<CollisionEvent>& out) {
+        uint32_t r = 0;
+        for (; r < n; ++r) {
+            if ((r & 7) == 0 && r + 8 <= n) {
+                uint64_t word;
+                std::memcpy(&word, bounce + r, sizeof(word));
+                if (word == 0) { r += 7; continue; }
+            }
+            const uint8_t bits = bounce[r];
+            if (!bits) continue;
+            const Entity self = scene.HandleOf(owners[r]);
+            for (uint8_t bit : { BOUNCE_MIN_X, BOUNCE_MAX_X, BOUNCE_MIN_Y, BOUNCE_MAX_Y })
+                if (bits & bit) out.push_back(CollisionEvent{ self, WALL_ENTITY });
+        }
+    }
+
+private:
+    // ParallelFor 조각 하나가 낸 벽 충돌 이벤트: m_scratch[worker].events 의 [begin, end)
+    struct EventSegment { uint32_t firstChunk, worker, begin, end; };
+
+    // 작업자별 임시 버퍼. 서로 다른 작업자가 같은 캐시 라인을 건드리지 않게 정렬한다.
+    struct alignas(CACHE_LINE) WorkerScratch {
+        std::vector<CollisionEvent> events;
+        std::vector<EventSegment> segments;
+        std::vector<uint8_t> bounce;
+        std::vector<uint64_t> lines;    // 이번 청크에서 처리할 캐시 라인 비트
+    };
+
+    SimdLevel m_simdLevel = SimdLevel::Scalar;
+    IntegrateBounceKernel m_kernel = IntegrateBounceScalar;
+    bool m_deltaCopy = true;
+    BroadPhaseMode m_broadPhase = BroadPhaseMode::UniformGrid;
+    JobSystem& m_jobs;
+    std::vector<WorkerScratch> m_scratch;
+    std::vector<ArchetypeChunk*> m_chunks;   // 이번 틱에 처리할 청크 (재사용)
+
+    std::vector<ArchetypeChunk*> m_bodyChunks;   // 충돌 대상 청크 (잠든 청크 포함)
+    std::vector<uint32_t> m_bodyOffsets;         // 청크별 m_bodies 시작 위치
+    CollisionBodies m_bodies;
+    std::vector<WorkerPairs> m_pairs;
+    std::vector<uint64_t> m_pairKeys, m_pairKeysTemp;   // 정렬·중복 제거된 이번 틱의 쌍
+    std::vector<uint64_t> m_contactKeys;                // 지난 틱까지 닿아 있던 쌍 (정렬됨)
+    std::vector<uint64_t> m_startedKeys;                // 이번 틱에 새로 닿은 쌍
+    std::vector<EventSegment> m_segments;
+    std::vector<CollisionEvent> m_tickEvents;           // 채널에 넘길 이번 틱 이벤트 (재사용)
+    UniformGridBroadPhase m_grid;
+    SweepAndPruneBroadPhase m_sweep;
+};
+
+struct RenderPacket { char symbol; int x, y; };
+
+class RenderSystem {
+public:
+    explicit RenderSystem(JobSystem& jobs) : m_jobs(jobs) {}
+
+    // CollectParallel: 우편함에서 가져온 완성된 버퍼만 읽으므로 물리와 동시에 돌 수 있다
+    static SystemAccess Access() {
+        return SystemAccess().ReadSnapshot<TransformComponent>().Read<RenderComponent>().WriteResource(RESOURCE_RENDER_PACKETS);
+    }
+
+    // Transform+Render 아키타입의 청크만 순회
+    void Collect(const Scene& scene, std::vector<RenderPacket>& packets) {
+        const int front = scene.LoadFrontIndex();
+        packets.clear();
+        scene.EachChunk<TransformComponent, RenderComponent>([&](const ArchetypeChunk& chunk) { AppendChunk(chunk, front, packets); });
+    }
+
+    // 프레임 사이(물리가 돌지 않을 때) 메인 루프에서 호출. 우편함에서 가장 최근 스텝의 버퍼를 가져오고,
+    // 새 스텝이면 바로 앞 스텝(프레임 번호 - 1)이 남아 있는 버퍼에서 위치를 엔티티별로 복사해 둔다.
+    // 앞 스텝 버퍼는 이번 프레임에 물리가 다시 쓸 수 있으므로 지금 복사해야 한다. 스텝이 없었으면 지난 쌍을 그대로 쓴다.
+    // alpha 는 그 최근 스텝에서 누산기에 남은 시간의 비율 (FixedTimestep::Alpha).
+    void BeginFrame(const Scene& scene, double alpha) {
+        m_alpha = alpha;
+        m_buffer = scene.AcquireTransformsForRead();
+        const uint64_t frame = scene.TransformFrame(m_buffer);
+        if (frame == m_frame) return;
+        m_frame = frame;
+
+        int previous = -1;
+        for (int b = 0; b < TRANSFORM_BUFFERS; ++b)
+            if (b != m_buffer && scene.TransformFrame(b) + 1 == frame) previous = b;
+        if (previous < 0) return;   // 앞 스텝이 없음: 이번 쌍은 보간하지 않는다
+
+        if (m_previousX.size() < scene.Capacity()) {
+            m_previousX.resize(scene.Capacity()); m_previousY.resize(scene.Capacity()); m_previousFrame.resize(scene.Capacity(), UINT64_MAX);
+        }
+        scene.CollectChunks<TransformComponent, RenderComponent>(m_chunks);
+        m_jobs.ParallelFor((uint32_t)m_chunks.size(), 1, [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t c = begin; c < end; ++c) {
+                const ArchetypeChunk& chunk = *m_chunks[c];
+                const ConstTransformColumns transforms = chunk.Columns<TransformComponent>(previous);
+                const EntityIndex* owners = chunk.Entities();
+                for (uint32_t r = 0; r < chunk.Count(); ++r) {
+                    m_previousX[owners[r]] = transforms.x[r];
+                    m_previousY[owners[r]] = transforms.y[r];
+                    m_previousFrame[owners[r]] = frame;
+                }
+            }
+        });
+    }
+
+    // 병렬 파이프라인용 수집: BeginFrame 이 가져온 버퍼만 읽으므로 물리가 몇 스텝을 더 돌아도 안전하다.
+    // 앞 스텝 위치가 있는 엔티티는 앞 스텝과 최근 스텝 사이를 alpha 로 보간한다 (렌더는 한 스텝 늦게 보여준다).
+    // 청크마다 따로 모은 뒤 청크 순서대로 이어 붙이므로 결과(겹칠 때 그리는 순서 포함)는 Collect 와 같다.
+    void CollectParallel(const Scene& scene, std::vector<RenderPacket>& packets) {
+        const int curFront = m_buffer;
+        scene.CollectChunks<TransformComponent, RenderComponent>(m_chunks);
+        if (m_chunkPackets.size() < m_chunks.size()) m_chunkPackets.resize(m_chunks.size());
+
+        m_jobs.ParallelFor((uint32_t)m_chunks.size(), 1, [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t c = begin; c < end; ++c) {
+                m_chunkPackets[c].clear();
+                AppendInterpolated(*m_chunks[c], curFront, m_chunkPackets[c]);
+            }
+        });
+
+        packets.clear();
+        for (size_t c = 0; c < m_chunks.size(); ++c)
+            packets.insert(packets.end(), m_chunkPackets[c].begin(), m_chunkPackets[c].end());
+    }
+
+    // e 를 이번 프레임에 그릴 위치 (CollectParallel 과 같은 보간, 정수로 자르기 전). Transform+Render 가 없으면 nullopt
+    std::optional<TransformComponent> DrawnTransform(const Scene& scene, Entity e) {
+        if (!scene.IsAlive(e)) return std::nullopt;
+        scene.CollectChunks<TransformComponent, RenderComponent>(m_chunks);
+        for (const ArchetypeChunk* chunk : m_chunks) {
+            const ConstTransformColumns transforms = chunk->Columns<TransformComponent>(m_buffer);
+            for (uint32_t r = 0; r < chunk->Count(); ++r)
+                if (chunk->Entities()[r] == e.index) return Interpolate(e.index, transforms.x[r], transforms.y[r]);
+        }
+        return std::nullopt;
+    }
+
+private:
+    static void AppendChunk(const ArchetypeChunk& chunk, int buffer, std::vector<RenderPacket>& packets) {
+        const ConstTransformColumns transforms = chunk.Columns<TransformComponent>(buffer);
+        const RenderComponent* renders = chunk.Column<RenderComponent>();
+        const uint32_t n = chunk.Count();
+        for (uint32_t r = 0; r < n; ++r) {
+            if (renders[r].symbol == '\0') continue;
+            packets.push_back({ renders[r].symbol, (int)transforms.x[r], (int)transforms.y[r] });
+        }
+    }
+
+    void AppendInterpolated(const ArchetypeChunk& chunk, int buffer, std::vector<RenderPacket>& packets) const {
+        const ConstTransformColumns transforms = chunk.Columns<TransformComponent>(buffer);
+        const RenderComponent* renders = chunk.Column<RenderComponent>();
+        const EntityIndex* owners = chunk.Entities();
+        const uint32_t n = chunk.Count();
+        for (uint32_t r = 0; r < n; ++r) {
+            if (renders[r].symbol == '\0') continue;
+            const TransformComponent drawn = Interpolate(owners[r], transforms.x[r], transforms.y[r]);
+            packets.push_back({ renders[r].symbol, (int)drawn.x, (int)drawn.y });
+        }
+    }
+
+    // 최근 스텝 위치 (x, y) 를 앞 스텝 위치와 alpha 로 보간 (앞 스텝 위치가 없으면 그대로)
+    TransformComponent Interpolate(EntityIndex e, double x, double y) const {
+        if (e >= m_previousFrame.size() || m_previousFrame[e] != m_frame) return { x, y };
+        return { m_previousX[e] + (x - m_previousX[e]) * m_alpha, m_previousY[e] + (y - m_previousY[e]) * m_alpha };
+    }
+
+    JobSystem& m_jobs;
+    std::vector<const ArchetypeChunk*> m_chunks;
+    std::vector<std::vector<RenderPacket>> m_chunkPackets;   // 청크별 수집 결과 (재사용)
+
+    // BeginFrame 이 정한 이번 프레임의 보간 쌍
+    int m_buffer = 0;                   // 최근 스텝 버퍼 (독자 소유)
+    uint64_t m_frame = UINT64_MAX;      // 그 버퍼의 프레임 번호 (아직 없으면 UINT64_MAX)
+    double m_alpha = 1.0;
+    std::vector<double> m_previousX, m_previousY;   // 엔티티 인덱스 -> 앞 스텝 위치
+    std::vector<uint64_t> m_previousFrame;          // 엔티티 인덱스 -> 위 위치가 앞 스텝인 m_frame (아니면 보간 안 함)
+};
+
+inline uint32_t FloorLog2(uint64_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanReverse64(&index, v);
+#else
+    // 32비트 빌드에는 64비트 스캔이 없다: 위 절반부터
+    if (_BitScanReverse(&index, (unsigned long)(v >> 32))) return (uint32_t)index + 32;
+    _BitScanReverse(&index, (unsigned long)v);
+#endif
+    return (uint32_t)index;
+#else
+    return 63u - (uint32_t)__builtin_clzll(v);
+#endif
+}
+
+// 지연 히스토그램 (ns). 2의 거듭제곱 구간마다 4칸으로 나눈 로그 눈금이라 상대 오차는 25% 이내이고,
+// 기록은 나눗셈 없이 비트 연산 몇 번이다. 한 스레드에서만 기록한다.
+class LatencyHistogram {
+public:
+    void Record(int64_t ns) {
+        const uint64_t v = ns > 0 ? (uint64_t)ns : 0;
+        ++m_buckets[BucketOf(v)];
+        ++m_count;
+        m_sum += (double)v;
+        m_max = std::max(m_max, v);
+    }
+
+    uint64_t Count() const { return m_count; }
+    double MeanNs() const { return m_count ? m_sum / m_count : 0.0; }
+    uint64_t MaxNs() const { return m_max; }
+
+    // 기록의 fraction 이상이 들어가는 가장 작은 구간의 상한
+    uint64_t PercentileNs(double fraction) const {
+        if (m_count == 0) return 0;
+        const uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(fraction * (double)m_count));
+        uint64_t seen = 0;
+        for (uint32_t b = 0; b < BUCKETS; ++b) {
+            seen += m_buckets[b];
+            if (seen >= rank) return std::min(UpperBound(b), m_max);
+        }
+        return m_max;
+    }
+
+    void Print(const char* name) const {
+        printf("[Latency] %-14s n=%llu  mean %.1fus  p50 %.1fus  p99 %.1fus  max %.1fus\n", name, (unsigned long long)m_count,
+            MeanNs() / 1e3, PercentileNs(0.50) / 1e3, PercentileNs(0.99) / 1e3, m_max / 1e3);
+    }
+
+private:
+    static const uint32_t SUB_BITS = 2;
+    static const uint32_t BUCKETS = 64 << SUB_BITS;
+
+    // 8 미만은 값 그대로, 그 위는 (최상위 비트 위치, 그 아래 두 비트)
+    static uint32_t BucketOf(uint64_t v) {
+        if (v < (2u << SUB_BITS)) return (uint32_t)v;
+        const uint32_t msb = FloorLog2(v);
+        return ((msb - SUB_BITS + 1) << SUB_BITS) | (uint32_t)((v >> (msb - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+    }
+    static uint64_t UpperBound(uint32_t b) {
+        if (b < (2u << SUB_BITS)) return b;
+        const uint32_t msb = (b >> SUB_BITS) + SUB_BITS - 1;
+        const uint64_t lower = (uint64_t)((1u << SUB_BITS) | (b & ((1u << SUB_BITS) - 1))) << (msb - SUB_BITS);
+        return lower + (1ull << (msb - SUB_BITS)) - 1;
+    }
+
+    uint64_t m_buckets[BUCKETS] = {};
+    uint64_t m_count = 0;
+    double m_sum = 0.0;
+    uint64_t m_max = 0;
+};
+
+// 게임 로직 스레드가 한 번에 적용하는 이벤트 상한 (그동안 체력 잠금을 잡고 있으므로 그리기가 오래 막히지 않게)
+const size_t DAMAGE_BATCH_MAX = 1024;
+
+// CollisionEvent 채널의 유일한 소비자. 로그를 출력한다.
+// 스케줄러가 아닌 자기 스레드에서 돌므로 체력, 콘솔, Scene 구조는 접근 선언 대신 stateMutex 로 지킨다.
+class DamageSystem {
+public:
+    // 게임 로직 스레드 본체. 충돌 채널에서 잠들어 있다가 이벤트가 오면 깨어나 그때 쌓인 것을 (최대 DAMAGE_BATCH_MAX 개) 한 번에 처리한다.
+    // 체력과 콘솔은 프레임 쪽(그리기)과 같이 쓰고 생존 확인은 Scene 구조를 읽으므로 stateMutex 를 잡고 적용한다.
+    // timeout 마다 한 번씩은 깨어나고, events.Close() 후 남은 이벤트까지 처리하면 반환한다.
+    // 지연은 push 시각이 실린 이벤트만 기록한다 (EventChannels::SetPushStamps).
+    void RunUntilClosed(Scene& scene, GameEvents& events, std::mutex& stateMutex, std::chrono::nanoseconds timeout) {
+        EventQueue<CollisionEvent>& collisions = events.Channel<CollisionEvent>();
+        for (;;) {
+            m_pending.clear();
+            m_pushedNs.clear();
+            if (collisions.WaitPopBatch(m_pending, DAMAGE_BATCH_MAX, timeout, &m_pushedNs) == 0) {
+                if (collisions.IsClosed() && collisions.Empty()) return;
+                continue;
+            }
+            const int64_t poppedNs = SteadyNowNs();
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                Apply(scene, m_pending.data(), m_pending.size());
+            }
+            const int64_t appliedNs = SteadyNowNs();
+            for (int64_t pushed : m_pushedNs) {
+                if (pushed == 0) continue;
+                m_queueLatency.Record(poppedNs - pushed);
+                m_applyLatency.Record(appliedNs - pushed);
+            }
+        }
+    }
+
+    // push -> 소비자가 깨어나 꺼낸 시각 / push -> 체력 적용을 마친 시각
+    const LatencyHistogram& QueueLatency() const { return m_queueLatency; }
+    const LatencyHistogram& ApplyLatency() const { return m_applyLatency; }
+
+    // 이벤트가 큐에 있는 동안 파괴/재사용된 엔티티와 체력이 없는 엔티티는 무시
+    void Apply(Scene& scene, const CollisionEvent* evs, size_t count) {
+        for (size_t k = 0; k < count; ++k) {
+            const CollisionEvent& ev = evs[k];
+            if (ev.b == WALL_ENTITY) {
+                HealthComponent* health = scene.TryGet<HealthComponent>(ev.a);
+                if (!health) continue;
+                auto& hp = health->health;
+                if (hp > 0) {
+                    hp = std::max(0, hp - 10);
+                    std::cout << "[Event] Entity " << ev.a.index << " hit a wall! HP: " << hp << std::endl;
+                }
+                continue;
+            }
+            // 엔티티끼리: 양쪽 모두
+            for (const auto& [self, other] : { std::pair{ ev.a, ev.b }, std::pair{ ev.b, ev.a } }) {
+                HealthComponent* health = scene.TryGet<HealthComponent>(self);
+                if (!health || health->health <= 0) continue;
+                health->health = std::max(0, health->health - 10);
+                std::cout << "[Event] Entity " << self.index << " hit Entity " << other.index << "! HP: " << health->health << std::endl;
+            }
+        }
+    }
+
+private:
+    std::vector<CollisionEvent> m_pending; // WaitPopBatch 대상 (재사용해서 매번 할당하지 않음)
+    std::vector<int64_t> m_pushedNs;       // m_pending 과 같은 순서의 push 시각
+    LatencyHistogram m_queueLatency;
+    LatencyHistogram m_applyLatency;
+};
+
+// 물리 고정 스텝. 렌더 프레임과 무관하게 같은 dt 로 적분하므로 시뮬레이션 결과가 프레임 간격에 흔들리지 않는다.
+const double PHYSICS_HZ = 120.0;
+const int MAX_PHYSICS_SUBSTEPS = 8;   // 한 프레임에 따라잡을 최대 스텝 (120Hz 면 약 67ms)
+
+// 고정 스텝 누산기. 실제로 흐른 시간을 모아 dt 단위 스텝 수로 바꾸고, 남은 시간의 비율(alpha)을 렌더 보간에 넘긴다.
+// 한 프레임에 maxSubsteps 보다 많이 밀리면 (디버거 정지, 아주 느린 프레임) 넘친 시간은 버린다.
+// 따라잡으려다 프레임이 더 느려지는 악순환을 막기 위함이며, 그동안은 시뮬레이션이 실제보다 느리게 간다.
+class FixedTimestep {
+public:
+    FixedTimestep(double hz, int maxSubsteps) : m_dt(1.0 / hz), m_maxSubsteps(maxSubsteps) {}
+
+    double Dt() const { return m_dt; }
+
+    // 흐른 시간을 더하고 이번에 돌릴 스텝 수를 반환
+    int Advance(double elapsedSeconds) {
+        m_accumulator += std::max(0.0, elapsedSeconds);
+        int steps = (int)(m_accumulator / m_dt);
+        if (steps > m_maxSubsteps) {
+            m_droppedSteps += (uint64_t)(steps - m_maxSubsteps);
+            steps = m_maxSubsteps;
+            m_accumulator = std::fmod(m_accumulator, m_dt);
+        } else {
+            m_accumulator = std::max(0.0, m_accumulator - steps * m_dt);
+        }
+        return steps;
+    }
+
+    // 마지막 스텝 이후 남은 시간 / dt, [0, 1)
+    double Alpha() const { return std::min(m_accumulator / m_dt, 1.0); }
+    uint64_t DroppedSteps() const { return m_droppedSteps; }
+
+private:
+    double m_dt;
+    int m_maxSubsteps;
+    double m_accumulator = 0.0;
+    uint64_t m_droppedSteps = 0;
+};
+
+// 프레임 페이서. 매 프레임 남은 시간만큼 상대 sleep 하면 sleep 의 과대 지연(리눅스는 스케줄러 퀀텀까지)이 그대로 프레임 간격에 섞이고
+// 오차도 누적된다. 대신 시작 시각 + k * period 의 절대 마감까지 OS 타이머로 자고, 마지막 spinTail 만큼은 시계를 돌며 기다린다.
+// 일이 늦어 마감을 한 주기 이상 넘기면 밀린 프레임을 몰아서 돌지 않고 지금부터 다시 센다.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 깨어난 시각 - 마감 (양수면 늦게 깸). 일이 마감을 넘겨 기다리지 않은 프레임은 overruns 로만 센다.
+    struct JitterStats {
+        uint64_t frames = 0;
+        uint64_t overruns = 0;
+        double meanUs = 0.0;
+        double stddevUs = 0.0;
+        double maxUs = 0.0;
+    };
+
+    explicit FramePacer(Clock::duration period, Clock::duration spinTail = std::chrono::microseconds(200))
+        : m_period(period), m_spinTail(spinTail) {
+#ifdef _WIN32
+        // 고해상도 대기 타이머 (Windows 10 1803+). 없으면 일반 타이머, 그것도 없으면 sleep_for 로 대신한다
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!m_timer) m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+#endif
+        Reset();
+    }
+    ~FramePacer() {
+#ifdef _WIN32
+        if (m_timer) CloseHandle(m_timer);
+#endif
+    }
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // 지금부터 주기를 다시 센다
+    void Reset() { m_deadline = Clock::now() + m_period; }
+
+    // 이번 프레임 마감까지 기다리고 다음 마감을 잡는다
+    void Wait() {
+        const Clock::time_point deadline = m_deadline;
+        Clock::time_point now = Clock::now();
+        if (now >= deadline) {
+            ++m_overruns;
+            m_deadline = now - deadline >= m_period ? now + m_period : deadline + m_period;
+            return;
+        }
+        if (deadline - now > m_spinTail) SleepUntil(deadline - m_spinTail);
+        while ((now = Clock::now()) < deadline) std::this_thread::yield();
+
+        const double lateUs = std::chrono::duration<double, std::micro>(now - deadline).count();
+        ++m_frames;
+        m_sumUs += lateUs;
+        m_sumSqUs += lateUs * lateUs;
+        m_maxUs = std::max(m_maxUs, lateUs);
+        m_deadline = deadline + m_period;
+    }
+
+    JitterStats Stats() const {
+        JitterStats stats;
+        stats.frames = m_frames;
+        stats.overruns = m_overruns;
+        if (m_frames > 0) {
+            stats.meanUs = m_sumUs / m_frames;
+            stats.stddevUs = std::sqrt(std::max(0.0, m_sumSqUs / m_frames - stats.meanUs * stats.meanUs));
+            stats.maxUs = m_maxUs;
+        }
+        return stats;
+    }
+
+private:
+    void SleepUntil(Clock::time_point target) {
+#ifdef _WIN32
+        if (m_timer) {
+            // 대기 타이머의 절대 시각은 벽시계 기준이라 상대 시간(100ns 단위, 음수)으로 건다
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(target - Clock::now()).count();
+            if (remaining <= 0) return;
+            LARGE_INTEGER due;
+            due.QuadPart = -(LONGLONG)((remaining + 99) / 100);
+            if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) {
+                WaitForSingleObject(m_timer, INFINITE);
+                return;
+            }
+        }
+        std::this_thread::sleep_until(target);
+#else
+        timespec ts;
+        if (!ToMonotonicTimespec(target, ts)) return;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#endif
+    }
+
+    Clock::duration m_period;
+    Clock::duration m_spinTail;
+    Clock::time_point m_deadline;
+#ifdef _WIN32
+    HANDLE m_timer = nullptr;
+#endif
+    uint64_t m_frames = 0;
+    uint64_t m_overruns = 0;
+    double m_sumUs = 0.0;
+    double m_sumSqUs = 0.0;
+    double m_maxUs = 0.0;
+};
+
+#ifdef _WIN32
+void ClearScreen() {
+    HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (hStdOut == INVALID_HANDLE_VALUE) return;
+    CONSOLE_SCREEN_BUFFER_INFO csbi;
+    if (!GetConsoleScreenBufferInfo(hStdOut, &csbi)) return;
+    DWORD cellCount = csbi.dwSize.X * csbi.dwSize.Y;
+    DWORD written;
+    COORD homeCoords = { 0, 0 };
+    FillConsoleOutputCharacter(hStdOut, (TCHAR)' ', cellCount, homeCoords, &written);
+    FillConsoleOutputAttribute(hStdOut, csbi.wAttributes, cellCount, homeCoords, &written);
+    SetConsoleCursorPosition(hStdOut, homeCoords);
+}
+#else
+void ClearScreen() {
+    printf("\x1b[2J\x1b[H");
+}
+#endif
+
+class Renderer {
+public:
+    // 화면을 그리고 HUD 에 체력을 표시한다
+    static SystemAccess Access() {
+        return SystemAccess().Read<HealthComponent>().ReadResource(RESOURCE_RENDER_PACKETS).WriteResource(RESOURCE_CONSOLE);
+    }
+
+    void Draw(const std::vector<RenderPacket>& packets, const Scene& scene) {
+        ClearScreen();
+        char screen[25][81];
+        for (int y = 0; y < 25; ++y) for (int x = 0; x < 81; ++x) screen[y][x] = ' ';
+        for (int i = 0; i < 25; ++i) screen[i][80] = '\0';
+
+        for (const auto& p : packets) {
+            if (p.y >= 0 && p.y < 25 && p.x >= 0 && p.x < 80) screen[p.y][p.x] = p.symbol;
+        }
+
+        for (int y = 0; y < 25; ++y) printf("%s\n", screen[y]);
+        printf("--------------------------------------------------------------------------------\n");
+        const auto& healths = scene.GetHealths();
+        const EntityIndex shown = std::min<EntityIndex>(10, scene.Capacity());
+        for (EntityIndex i = 0; i < shown; ++i) {
+            if (!scene.IsActive(i)) continue;
+            if (const HealthComponent* h = healths.TryGet(i)) printf("[Entity %d] HP: %d | ", i, h->health);
+        }
+        printf("\n");
+    }
+};
+
+// ---------------------------------------------------------------------------
+// 마이크로벤치마크 (Thread.exe --bench)
+// ---------------------------------------------------------------------------
+
+// producers 개의 스레드가 각각 perProducer 개의 이벤트를 넣고, 호출 스레드가 모두 꺼낼 때까지의 처리량
+template <typename Queue>
+double BenchQueueThroughput(Queue& queue, int producers, int perProducer) {
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int i = 0; i < perProducer; ++i) queue.Push(CollisionEvent{ Entity{ (EntityIndex)p, 0 }, Entity{ (EntityIndex)i, 0 } });
+        });
+    }
+
+    const long long total = (long long)producers * perProducer;
+    long long popped = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    while (popped < total) {
+        if (queue.TryPop()) ++popped;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (auto& t : threads) t.join();
+
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+    return total / sec / 1e6;
+}
+
+// 생산자가 batchSize 개씩 모아 PushBatch, 소비자는 DrainInto 로 한 번에 꺼낸다
+double BenchQueueBatchedThroughput(EventQueue<CollisionEvent>& queue, int producers, int perProducer, int batchSize) {
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            std::vector<CollisionEvent> batch;
+            batch.reserve(batchSize);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int i = 0; i < perProducer; ++i) {
+                batch.push_back(CollisionEvent{ Entity{ (EntityIndex)p, 0 }, Entity{ (EntityIndex)i, 0 } });
+                if ((int)batch.size() == batchSize) { queue.PushBatch(batch); batch.clear(); }
+            }
+            queue.PushBatch(batch);
+        });
+    }
+
+    const long long total = (long long)producers * perProducer;
+    long long popped = 0;
+    std::vector<CollisionEvent> out;
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    while (popped < total) {
+        out.clear();
+        popped += queue.DrainInto(out);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (auto& t : threads) t.join();
+
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+    return total / sec / 1e6;
+}
+
+void RunEventQueueBenchmark() {
+    const int perProducer = 200000;
+    const int batchSize = 256;
+    printf("[EventQueue] producers | deque+mutex (Mev/s) | mpsc ring (Mev/s) | ring batch%d (Mev/s)\n", batchSize);
+    for (int producers : { 1, 2, 4, 8 }) {
+        LockedEventQueue locked;
+        EventQueue<CollisionEvent> ring(1 << 16, OverflowPolicy::Block);
+        double a = BenchQueueThroughput(locked, producers, perProducer);
+        double b = BenchQueueThroughput(ring, producers, perProducer);
+        EventQueue<CollisionEvent> batched(1 << 16, OverflowPolicy::Block);
+        double c = BenchQueueBatchedThroughput(batched, producers, perProducer, batchSize);
+        printf("  %9d | %19.2f | %17.2f | %20.2f\n", producers, a, b, c);
+    }
+}
+
+// 64바이트 정렬된 double 배열 (벤치마크용)
+class AlignedDoubles {
+public:
+    explicit AlignedDoubles(size_t n)
+        : m_data((double*)::operator new[](n * sizeof(double), std::align_val_t(CACHE_LINE))) {}
+    ~AlignedDoubles() { ::operator delete[](m_data, std::align_val_t(CACHE_LINE)); }
+    AlignedDoubles(const AlignedDoubles&) = delete;
+    AlignedDoubles& operator=(const AlignedDoubles&) = delete;
+    double* Data() { return m_data; }
+private:
+    double* m_data;
+};
+
+// 적분+경계 보정을 기존 AoS 루프와 SoA 루프(PhysicsSystem 과 같은 2단계)로 각각 돌려 엔티티당 비용 비교
+void BenchLayout(size_t n, int ticks) {
+    std::vector<TransformComponent> aosPos[2] = { std::vector<TransformComponent>(n), std::vector<TransformComponent>(n) };
+    std::vector<PhysicsComponent> aosVel(n);
+    AlignedDoubles sx0(n), sy0(n), sx1(n), sy1(n), svx(n), svy(n);
+    TransformColumns soaPos[2] = { { sx0.Data(), sy0.Data() }, { sx1.Data(), sy1.Data() } };
+    PhysicsColumns soaVel{ svx.Data(), svy.Data() };
+
+    uint32_t seed = 12345;
+    auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+    for (size_t i = 0; i < n; ++i) {
+        TransformComponent t{ rnd() * 79, rnd() * 24 };
+        PhysicsComponent v{ rnd() - 0.5, rnd() - 0.5 };
+        aosPos[0][i] = t; aosVel[i] = v;
+        soaPos[0].x[i] = t.x; soaPos[0].y[i] = t.y; soaVel.vx[i] = v.vx; soaVel.vy[i] = v.vy;
+    }
+
+    const double dt = 1.0;   // 속도를 틱당 거리로 둔다
+    std::vector<CollisionEvent> batch;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        batch.clear();
+        const auto& src = aosPos[tick & 1];
+        auto& dst = aosPos[1 - (tick & 1)];
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i];
+            PhysicsComponent& p = aosVel[i];
+            if (p.vx != 0.0 || p.vy != 0.0) {
+                dst[i].x += p.vx * dt;
+                dst[i].y += p.vy * dt;
+                if (dst[i].x < 0) { dst[i].x = 0; p.vx *= -1; batch.push_back(CollisionEvent{}); }
+                if (dst[i].x > 79) { dst[i].x = 79; p.vx *= -1; batch.push_back(CollisionEvent{}); }
+                if (dst[i].y < 0) { dst[i].y = 0; p.vy *= -1; batch.push_back(CollisionEvent{}); }
+                if (dst[i].y > 24) { dst[i].y = 24; p.vy *= -1; batch.push_back(CollisionEvent{}); }
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    // SoA 는 PhysicsSystem 과 같은 경로: 아키타입 청크와 비슷한 크기의 블록마다 (CPU 에 맞는) 커널 후 반사 비트를 훑는다
+    const IntegrateBounceKernel kernel = SelectIntegrateKernel(DetectSimdLevel());
+    const uint32_t block = 256;
+    std::vector<uint8_t> bounce(block);
+    std::vector<EntityIndex> owners(block, 0);
+    Scene dummy(1);
+    for (int tick = 0; tick < ticks; ++tick) {
+        batch.clear();
+        const TransformColumns src = soaPos[tick & 1];
+        const TransformColumns dst = soaPos[1 - (tick & 1)];
+        for (size_t b = 0; b < n; b += block) {
+            kernel({ src.x + b, src.y + b }, { dst.x + b, dst.y + b }, { soaVel.vx + b, soaVel.vy + b }, bounce.data(), block, dt);
+            PhysicsSystem::EmitBounceEvents(dummy, owners.data(), bounce.data(), block, batch);
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    const double perEntity = 1e9 / (double(n) * ticks);
+    printf("  %10zu | %18.3f | %24.3f\n", n,
+        std::chrono::duration<double>(t1 - t0).count() * perEntity, std::chrono::duration<double>(t2 - t1).count() * perEntity);
+}
+
+void RunLayoutBenchmark() {
+    // 캐시에 들어가는 크기와 메모리 대역폭에 묶이는 크기를 모두 본다
+    printf("[Layout]   entities | AoS branchy (ns/e) | SoA %s kernel (ns/e)\n", SimdLevelName(DetectSimdLevel()));
+    BenchLayout(1 << 12, 20000);
+    BenchLayout(1 << 16, 1000);
+    BenchLayout(1 << 20, 100);
+}
+
+// 적분+반사 커널을 SIMD 수준별로 돌려 처리량 비교. 각 수준의 결과가 스칼라 커널과 같은지도 확인한다.
+void BenchSimdKernels(size_t n, int ticks) {
+    AlignedDoubles x0(n), y0(n), x1(n), y1(n), vx(n), vy(n);
+    std::vector<uint8_t> bounce(n);
+
+    auto reset = [&]() {
+        uint32_t seed = 777;
+        auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+        for (size_t i = 0; i < n; ++i) {
+            x0.Data()[i] = rnd() * WORLD_MAX_X; y0.Data()[i] = rnd() * WORLD_MAX_Y;
+            vx.Data()[i] = (rnd() - 0.5) * PHYSICS_HZ; vy.Data()[i] = (i % 4 == 0) ? 0.0 : (rnd() - 0.5) * PHYSICS_HZ;
+        }
+    };
+
+    printf("  %10zu |", n);
+    double reference = 0.0;
+    const SimdLevel supported = DetectSimdLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if ((int)level > (int)supported) { printf(" %10s |", "n/a"); continue; }
+        const IntegrateBounceKernel kernel = SelectIntegrateKernel(level);
+        reset();
+        TransformColumns pos[2] = { { x0.Data(), y0.Data() }, { x1.Data(), y1.Data() } };
+        uint64_t bounces = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            kernel(pos[tick & 1], pos[1 - (tick & 1)], { vx.Data(), vy.Data() }, bounce.data(), (uint32_t)n, 1.0 / PHYSICS_HZ);
+            bounces += bounce[tick % n];
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        double checksum = (double)bounces;
+        for (size_t i = 0; i < n; ++i) checksum += pos[ticks & 1].x[i] + pos[ticks & 1].y[i] * 3 + vx.Data()[i] * 7;
+        if (level == SimdLevel::Scalar) reference = checksum;
+        printf(" %9.3f%s |", std::chrono::duration<double>(t1 - t0).count() * 1e9 / (double(n) * ticks), checksum == reference ? " " : "!");
+    }
+    printf("\n");
+}
+
+void RunSimdBenchmark() {
+    printf("[SIMD] detected: %s  (ns/entity, '!' = result differs from scalar)\n", SimdLevelName(DetectSimdLevel()));
+    printf("  %10s | %10s | %10s | %10s | %10s |\n", "entities", "scalar", "SSE4.2", "AVX2", "AVX-512");
+    BenchSimdKernels(1 << 12, 20000);
+    BenchSimdKernels(1 << 16, 1000);
+    BenchSimdKernels(1 << 20, 100);
+}
+
+// 정지/이동 엔티티 비율별로 물리 한 틱의 엔티티당 비용 비교: 모든 행을 다시 쓰기 vs 바뀐 행만 쓰기
+// vs 바뀐 행만 쓰기 + 멈춘 엔티티 재우기 (UpdateSleeping 비용 포함).
+// 이동 엔티티는 무작위로 섞여 있다 (청크 단위로 몰려 있지 않음). 한 작업자로 돌려 메모리 트래픽만 본다.
+// 두 방식을 번갈아 여러 번 재서 가장 빠른 값을 쓴다 (클럭 변동 영향을 줄이기 위함).
+void BenchDeltaCopy(EntityIndex n, int ticks, double dynamicRatio) {
+    JobSystem jobs(1);
+    struct Setup {
+        Scene scene;
+        GameEvents events{ 1 << 16, OverflowPolicy::DropNewest };
+        PhysicsSystem physics;
+        double best = 1e300;
+        Setup(EntityIndex n, JobSystem& jobs) : scene(n), physics(jobs) {}
+    };
+    std::unique_ptr<Setup> setups[3];
+    for (int mode = 0; mode < 3; ++mode) {
+        setups[mode] = std::make_unique<Setup>(n, jobs);
+        Setup& s = *setups[mode];
+        s.physics.SetDeltaCopy(mode >= 1);
+        s.physics.SetBroadPhase(BroadPhaseMode::None);   // 적분 비용만
+        uint32_t seed = 4242;
+        auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+        for (EntityIndex i = 0; i < n; ++i) {
+            Entity e = s.scene.CreateEntity();
+            s.scene.SetTransform(e, { rnd() * WORLD_MAX_X, rnd() * WORLD_MAX_Y });
+            const bool dynamic = rnd() < dynamicRatio;
+            s.scene.Add(e, dynamic ? PhysicsComponent{ (rnd() - 0.5) * 0.01 * PHYSICS_HZ, (rnd() - 0.5) * 0.01 * PHYSICS_HZ } : PhysicsComponent{});
+        }
+        for (int tick = 0; tick < TRANSFORM_BUFFERS; ++tick) s.physics.UpdateParallel(s.scene, s.events, 1.0 / PHYSICS_HZ); // 처음 쓰기로 낡은 표시를 털어 냄
+        if (mode == 2) s.scene.UpdateSleeping();
+    }
+
+    std::vector<CollisionEvent> drained;
+    const int trials = 5;
+    for (int trial = 0; trial < trials; ++trial) {
+        for (int mode = 0; mode < 3; ++mode) {
+            Setup* setup = setups[mode].get();
+            auto t0 = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks / trials; ++tick) {
+                setup->physics.UpdateParallel(setup->scene, setup->events, 1.0 / PHYSICS_HZ);
+                if (mode == 2) setup->scene.UpdateSleeping();
+                drained.clear();
+                setup->events.Channel<CollisionEvent>().DrainInto(drained);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            setup->best = std::min(setup->best, std::chrono::duration<double>(t1 - t0).count() * 1e9 / (double(n) * (ticks / trials)));
+        }
+    }
+    printf("  %10u | %8.0f%% | %12.3f | %12.3f | %12.3f |\n", n, dynamicRatio * 100, setups[0]->best, setups[1]->best, setups[2]->best);
+}
+
+void RunDeltaCopyBenchmark() {
+    printf("[Delta] %s kernel, ns/entity per tick\n", SimdLevelName(DetectSimdLevel()));
+    printf("  %10s | %9s | %12s | %12s | %12s |\n", "entities", "dynamic", "full copy", "delta copy", "sleeping");
+    for (EntityIndex n : { 1u << 16, 1u << 20 }) {
+        const int ticks = n > (1u << 16) ? 50 : 500;
+        for (double ratio : { 0.0, 0.01, 0.1, 0.5, 1.0 }) BenchDeltaCopy(n, ticks, ratio);
+    }
+}
+
+// 물리 한 틱(적분 + 엔티티 충돌)의 비용을 broad-phase 방식별로 비교. None 은 적분만 한 기준선이다.
+// uniform: 월드 전체에 고르게, clustered: 납작한 무리 4개에 몰아서 (무리 한가운데는 고를 때보다 열 배쯤 빽빽함).
+// 모든 물체가 조금씩 움직이므로 정렬 후 훑기는 틱마다 삽입 정렬로 순서를 고친다.
+void BenchBroadPhase(JobSystem& jobs, const char* distribution, EntityIndex n, int ticks) {
+    const BroadPhaseMode modes[3] = { BroadPhaseMode::None, BroadPhaseMode::UniformGrid, BroadPhaseMode::SweepAndPrune };
+    struct Setup {
+        Scene scene;
+        GameEvents events{ 1 << 20, OverflowPolicy::DropNewest };
+        PhysicsSystem physics;
+        std::vector<CollisionEvent> drained;
+        double best = 1e300;
+        size_t pairs = 0;
+        Setup(EntityIndex n, JobSystem& jobs) : scene(n), physics(jobs) {}
+    };
+    const bool clustered = std::string(distribution) == "clustered";
+    std::unique_ptr<Setup> setups[3];
+    for (int mode = 0; mode < 3; ++mode) {
+        setups[mode] = std::make_unique<Setup>(n, jobs);
+        Setup& s = *setups[mode];
+        s.physics.SetBroadPhase(modes[mode]);
+        uint32_t seed = 777;
+        auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+        const double centers[4][2] = { { 12, 6 }, { 60, 18 }, { 30, 20 }, { 70, 4 } };
+        for (EntityIndex i = 0; i < n; ++i) {
+            Entity e = s.scene.CreateEntity();
+            if (clustered) {
+                const auto& c = centers[i % 4];
+                s.scene.SetTransform(e, { c[0] + (rnd() + rnd() + rnd() - 1.5) * 6, c[1] + (rnd() + rnd() + rnd() - 1.5) * 3 });
+            } else {
+                s.scene.SetTransform(e, { rnd() * WORLD_MAX_X, rnd() * WORLD_MAX_Y });
+            }
+            s.scene.Add(e, PhysicsComponent{ (rnd() - 0.5) * 0.05 * PHYSICS_HZ, (rnd() - 0.5) * 0.05 * PHYSICS_HZ });
+        }
+        s.physics.UpdateParallel(s.scene, s.events, 1.0 / PHYSICS_HZ);   // 정렬 후 훑기의 첫 정렬
+        s.events.Channel<CollisionEvent>().DrainInto(s.drained);
+    }
+
+    const int trials = 5;
+    for (int trial = 0; trial < trials; ++trial) {
+        for (auto& setup : setups) {
+            size_t pairs = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks / trials; ++tick) {
+                setup->physics.UpdateParallel(setup->scene, setup->events, 1.0 / PHYSICS_HZ);
+                setup->drained.clear();
+                setup->events.Channel<CollisionEvent>().DrainInto(setup->drained);
+                pairs += setup->drained.size();
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            setup->best = std::min(setup->best, std::chrono::duration<double>(t1 - t0).count() * 1e3 / (ticks / trials));
+            setup->pairs = pairs / (ticks / trials);
+        }
+    }
+    printf("  %10s | %8u | %10.3f | %10.3f | %10.3f | %12zu |\n", distribution, n,
+        setups[0]->best, setups[1]->best, setups[2]->best, setups[1]->pairs);
+}
+
+void RunBroadPhaseBenchmark() {
+    JobSystem jobs;
+    printf("[BroadPhase] ms per physics tick, %u workers\n", jobs.WorkerCount());
+    printf("  %10s | %8s | %10s | %10s | %10s | %12s |\n", "bodies", "count", "none", "grid", "sweep", "events/tick");
+    for (const char* distribution : { "uniform", "clustered" })
+        for (EntityIndex n : { 500u, 2000u, 5000u }) BenchBroadPhase(jobs, distribution, n, 100);
+}
+
+// 같은 일(약 2ms 바쁜 대기)을 하는 60Hz 루프를 상대 sleep_for, 페이서(스핀 없음), 페이서(스핀 200us)로 돌려 프레임 간격을 비교한다
+void BenchFramePacing(const char* name, int frames, const std::function<void()>& wait) {
+    using Clock = std::chrono::steady_clock;
+    const auto work = std::chrono::milliseconds(2);
+    std::vector<double> intervals;
+    intervals.reserve(frames);
+    Clock::time_point last = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        const Clock::time_point t0 = Clock::now();
+        while (Clock::now() - t0 < work) {}
+        wait();
+        const Clock::time_point now = Clock::now();
+        intervals.push_back(std::chrono::duration<double, std::milli>(now - last).count());
+        last = now;
+    }
+    double sum = 0.0, worst = 0.0;
+    for (double ms : intervals) { sum += ms; worst = std::max(worst, std::abs(ms - 1000.0 / 60.0)); }
+    std::sort(intervals.begin(), intervals.end());
+    printf("  %-16s | %8.3f | %8.3f | %8.3f | %8.3f |\n", name, sum / frames, intervals[frames / 100], intervals[frames - 1 - frames / 100], worst);
+}
+
+void RunFramePacingBenchmark() {
+    const int frames = 120;
+    const auto period = std::chrono::microseconds(1000000 / 60);
+    printf("[Pacing] 60Hz frame interval in ms, %d frames\n", frames);
+    printf("  %-16s | %8s | %8s | %8s | %8s |\n", "method", "mean", "p1", "p99", "max err");
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    BenchFramePacing("sleep_for", frames, [&] {
+        auto elapsed = std::chrono::steady_clock::now() - t0;
+        if (elapsed < period) std::this_thread::sleep_for(period - elapsed);
+        t0 = std::chrono::steady_clock::now();
+    });
+    for (auto spin : { std::chrono::microseconds(0), std::chrono::microseconds(200) }) {
+        FramePacer pacer(period, spin);
+        BenchFramePacing(spin.count() ? "pacer+spin" : "pacer", frames, [&] { pacer.Wait(); });
+        const FramePacer::JitterStats stats = pacer.Stats();
+        printf("  %-16s   wake late mean %.1fus, stddev %.1fus, max %.1fus, overruns %llu\n", "",
+            stats.meanUs, stats.stddevUs, stats.maxUs, (unsigned long long)stats.overruns);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 자가 점검 (Thread.exe --check). 실패하면 이유를 출력하고 false.
+// ---------------------------------------------------------------------------
+
+// 용량보다 큰 배치를 Block 정책으로 넣을 때, 잠들어 있던 소비자가 곧바로 깨어나 전부 받는지.
+// 소비자는 시간 제한 없이 WaitPop 으로 잠들고, 1초 안에 끝나지 않으면 감시 스레드가 Close 해서 풀어 준다.
+bool CheckQueueOverflowBatch() {
+    EventQueue<CollisionEvent> queue(1024, OverflowPolicy::Block);
+    const size_t total = 5000;
+    std::vector<CollisionEvent> batch;
+    for (size_t i = 0; i < total; ++i) batch.push_back(CollisionEvent{ Entity{ (EntityIndex)i, 0 }, WALL_ENTITY });
+
+    size_t received = 0;
+    bool ordered = true;
+    std::atomic<bool> done{ false };
+    std::thread consumer([&] {
+        while (received < total) {
+            std::optional<CollisionEvent> ev = queue.WaitPop();
+            if (!ev) break;
+            ordered &= ev->a.index == received;
+            ++received;
+        }
+        done.store(true, std::memory_order_release);
+    });
+    std::thread watchdog([&] {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!done.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        queue.Close();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));   // 소비자가 먼저 잠들게
+    queue.PushBatch(batch);
+    consumer.join();
+    watchdog.join();
+
+    if (received != total || !ordered || queue.DroppedCount() != 0) {
+        printf("[Check] queue overflow batch: received %zu/%zu, dropped %zu, ordered %d\n", received, total, queue.DroppedCount(), ordered);
+        return false;
+    }
+    return true;
+}
+
+// WaitPop 과 먼 deadline 의 WaitPopUntil 로 잠든 두 소비자가 Close 로 곧바로 깨어나는지,
+// 그리고 닫힌 뒤에도 남아 있던 이벤트는 계속 꺼내 주고 다 비면 잠들지 않고 돌아오는지.
+// (소비자는 하나여야 하므로 두 대기는 차례로 한다.)
+bool CheckQueueCloseWakesWaiters() {
+    bool ok = true;
+    for (int variant = 0; variant < 2; ++variant) {
+        EventQueue<CollisionEvent> queue(64);
+        std::optional<CollisionEvent> got{ CollisionEvent{} };
+        std::atomic<bool> returned{ false };
+        std::thread consumer([&] {
+            got = variant == 0 ? queue.WaitPop() : queue.WaitPopUntil(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+            returned.store(true, std::memory_order_release);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));   // 소비자가 먼저 잠들게
+        const auto closedAt = std::chrono::steady_clock::now();
+        queue.Close();
+        while (!returned.load(std::memory_order_acquire) && std::chrono::steady_clock::now() - closedAt < std::chrono::seconds(1))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const bool woke = returned.load(std::memory_order_acquire);
+        if (!woke) queue.Push(CollisionEvent{});   // 실패해도 join 은 되게 (WaitPop 은 이벤트로만 풀린다)
+        consumer.join();
+        if (!woke || got) {
+            printf("[Check] queue close: %s waiter %s\n", variant == 0 ? "WaitPop" : "WaitPopUntil",
+                woke ? "returned an event" : "did not wake within 1s");
+            ok = false;
+        }
+    }
+
+    EventQueue<CollisionEvent> queue(64);
+    for (EntityIndex i = 0; i < 3; ++i) queue.Push(CollisionEvent{ Entity{ i, 0 }, WALL_ENTITY });
+    queue.Close();
+    std::vector<CollisionEvent> leftovers;
+    while (std::optional<CollisionEvent> ev = queue.WaitPopFor(std::chrono::seconds(10))) leftovers.push_back(*ev);
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t afterEmpty = queue.WaitPopBatch(leftovers, 16, std::chrono::seconds(10));
+    const double emptyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (leftovers.size() != 3 || afterEmpty != 0 || emptyMs > 100.0) {
+        printf("[Check] queue close: %zu/3 leftovers, closed empty wait returned %zu after %.1fms\n", leftovers.size(), afterEmpty, emptyMs);
+        ok = false;
+    }
+    return ok;
+}
+
+// 이벤트가 없으면 WaitPopFor / WaitPopBatch 가 timeout 을 지키는지 (너무 일찍도, 한참 늦게도 돌아오지 않음).
+bool CheckQueueDeadline() {
+    EventQueue<CollisionEvent> queue(64);
+    const auto timeout = std::chrono::milliseconds(30);
+    bool ok = true;
+    for (int variant = 0; variant < 2; ++variant) {
+        std::vector<CollisionEvent> out;
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool got = variant == 0 ? queue.WaitPopFor(timeout).has_value() : queue.WaitPopBatch(out, 16, timeout) > 0;
+        const auto waited = std::chrono::steady_clock::now() - t0;
+        if (got || waited < timeout || waited > timeout + std::chrono::milliseconds(500)) {
+            printf("[Check] queue deadline: %s returned %s after %.1fms (timeout 30ms)\n", variant == 0 ? "WaitPopFor" : "WaitPopBatch",
+                got ? "an event" : "nothing", std::chrono::duration<double, std::milli>(waited).count());
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// 용량보다 큰 배치(Block)를 WaitPopBatch 소비자가 maxCount 씩 받아 자리를 비워 주며 전부, 순서대로 받는지.
+bool CheckQueueOverflowWaitBatch() {
+    EventQueue<CollisionEvent> queue(256, OverflowPolicy::Block);
+    const size_t total = 10000, maxCount = 100;
+    std::vector<CollisionEvent> batch;
+    for (size_t i = 0; i < total; ++i) batch.push_back(CollisionEvent{ Entity{ (EntityIndex)i, 0 }, WALL_ENTITY });
+
+    std::vector<CollisionEvent> received;
+    bool overTaken = false;
+    std::thread consumer([&] {
+        while (received.size() < total) {
+            const size_t taken = queue.WaitPopBatch(received, maxCount, std::chrono::seconds(1));
+            if (taken == 0) break;   // 1초 동안 아무것도 없으면 깨우기를 놓친 것
+            overTaken |= taken > maxCount;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.PushBatch(batch);
+    consumer.join();
+
+    bool ordered = received.size() == total;
+    for (size_t i = 0; ordered && i < total; ++i) ordered = received[i].a.index == i;
+    if (!ordered || overTaken || queue.DroppedCount() != 0) {
+        printf("[Check] queue overflow wait batch: received %zu/%zu, ordered %d, over maxCount %d, dropped %zu\n",
+            received.size(), total, ordered, overTaken, queue.DroppedCount());
+        return false;
+    }
+    return true;
+}
+
+// 두 스레드가 EventCount 로만 잠들고 깨우며 공을 주고받는다. 깨우기를 놓치면 대기가 1초 deadline 으로 풀리는데,
+// 그때 조건이 이미 참이면 놓친 것으로 센다 (무한 대기로 점검이 멈추지 않게).
+bool CheckEventCountPingPong() {
+    const int roundTrips = 20000;
+    EventCount wake[2];
+    std::atomic<int> ball{ 0 };   // 짝수면 0번, 홀수면 1번 스레드 차례
+    std::atomic<int> lost{ 0 };
+    auto player = [&](int self) {
+        for (int turn = self; turn < 2 * roundTrips; turn += 2) {
+            for (;;) {
+                if (ball.load(std::memory_order_acquire) == turn) break;
+                const uint32_t key = wake[self].PrepareWait();
+                if (ball.load(std::memory_order_acquire) == turn) { wake[self].CancelWait(); break; }
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                if (!wake[self].Wait(key, &deadline) && ball.load(std::memory_order_acquire) == turn)
+                    lost.fetch_add(1, std::memory_order_relaxed);
+                if (lost.load(std::memory_order_relaxed) > 3) return;
+            }
+            ball.store(turn + 1, std::memory_order_release);
+            wake[1 - self].NotifyOne();
+        }
+    };
+    std::thread other(player, 1);
+    player(0);
+    other.join();
+    if (lost.load() || ball.load() != 2 * roundTrips) {
+        printf("[Check] eventcount ping-pong: %d/%d passes, %d lost wakeups\n", ball.load(), 2 * roundTrips, lost.load());
+        return false;
+    }
+    return true;
+}
+
+// 아무도 깨우지 않으면 deadline 대기는 false 로, deadline 을 지난 뒤에 돌아온다.
+// PrepareWait 뒤에 Notify 가 있었으면 Wait 는 잠들지 않고 바로 돌아온다.
+bool CheckEventCountTimedWait() {
+    EventCount ec;
+    const auto timeout = std::chrono::milliseconds(30);
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t key = ec.PrepareWait();
+    auto deadline = t0 + timeout;
+    const bool woken = ec.Wait(key, &deadline);
+    const auto waited = std::chrono::steady_clock::now() - t0;
+
+    t0 = std::chrono::steady_clock::now();
+    key = ec.PrepareWait();
+    ec.NotifyOne();
+    deadline = t0 + std::chrono::seconds(10);
+    const bool notified = ec.Wait(key, &deadline);
+    const auto notifiedWait = std::chrono::steady_clock::now() - t0;
+
+    if (woken || waited < timeout || waited > timeout + std::chrono::milliseconds(500)
+        || !notified || notifiedWait > std::chrono::milliseconds(100)) {
+        printf("[Check] eventcount timed wait: unnotified wait returned %d after %.1fms (timeout 30ms), notified wait returned %d after %.1fms\n",
+            woken, std::chrono::duration<double, std::milli>(waited).count(),
+            notified, std::chrono::duration<double, std::milli>(notifiedWait).count());
+        return false;
+    }
+    return true;
+}
+
+// 살아 있는 작업이 작업자 풀(JOB_POOL_SIZE)보다 많아도 모든 작업이 정확히 한 번씩 도는지.
+// 부모 하나에 자식을 풀 몇 배만큼 매달아 한꺼번에 살려 두고, 큰 ParallelFor 도 grain 1 로 돌린다.
+bool CheckJobPoolOverflow() {
+    JobSystem jobs(2);
+    const uint32_t children = JOB_POOL_SIZE * 5;
+    std::vector<std::atomic<int>> hits(children);
+    Job* root = jobs.Create([](unsigned) {});
+    for (uint32_t i = 0; i < children; ++i) {
+        std::atomic<int>* hit = &hits[i];
+        jobs.Run(jobs.CreateChild(root, [hit](unsigned) { hit->fetch_add(1, std::memory_order_relaxed); }));
+    }
+    jobs.Run(root);
+    jobs.Wait(root);
+    uint32_t wrong = 0;
+    for (auto& hit : hits) wrong += hit.load(std::memory_order_relaxed) != 1;
+
+    const uint32_t items = 1u << 20;
+    std::vector<std::atomic<int>> itemHits(items);
+    for (int round = 0; round < 3; ++round)
+        jobs.ParallelFor(items, 1, [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t i = begin; i < end; ++i) itemHits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+    uint32_t wrongItems = 0;
+    for (auto& hit : itemHits) wrongItems += hit.load(std::memory_order_relaxed) != 3;
+
+    if (wrong || wrongItems) {
+        printf("[Check] job pool overflow: %u/%u children and %u/%u items not run exactly once\n", wrong, children, wrongItems, items);
+        return false;
+    }
+    return true;
+}
+
+// 파괴된 엔티티의 슬롯이 재사용된 뒤 옛 핸들이 새 엔티티에 닿지 않는지 (IsAlive, TryGet, Get, Add, DestroyEntity 모두).
+bool CheckStaleHandles() {
+    Scene scene(16);
+    const Entity old = scene.CreateEntity();
+    scene.SetTransform(old, { 1.0, 2.0 });
+    scene.Add(old, HealthComponent{ 50 });
+    scene.DestroyEntity(old);
+    const Entity reused = scene.CreateEntity();
+    const bool sameSlot = reused.index == old.index && reused.generation != old.generation;
+    const bool clean = !scene.TryGet<HealthComponent>(reused) && !scene.Get<TransformComponent>(reused);
+
+    scene.SetTransform(reused, { 3.0, 4.0 });
+    scene.Add(reused, HealthComponent{ 100 });
+    scene.Add(old, HealthComponent{ 1 });             // 무시돼야 한다
+    scene.SetTransform(old, { 9.0, 9.0 });
+    const bool rejected = !scene.IsAlive(old) && !scene.TryGet<HealthComponent>(old) && !scene.Get<TransformComponent>(old)
+        && !scene.DestroyEntity(old);
+    const HealthComponent* health = scene.TryGet<HealthComponent>(reused);
+    const std::optional<TransformComponent> pos = scene.Get<TransformComponent>(reused);
+    const bool untouched = scene.IsAlive(reused) && health && health->health == 100 && pos && pos->x == 3.0 && pos->y == 4.0;
+
+    if (!sameSlot || !clean || !rejected || !untouched) {
+        printf("[Check] stale handles: slot reused %d, new entity clean %d, old handle rejected %d, new entity untouched %d\n",
+            sameSlot, clean, rejected, untouched);
+        return false;
+    }
+    return true;
+}
+
+// 멈춘 물체는 UpdateSleeping 으로 잠든 아키타입에 들어가 적분에서 빠지고 (Each 로 속도를 줘도 움직이지 않음),
+// SetVelocity 로 깨우면 위치는 그대로인 채 다음 틱부터 다시 적분되는지. 움직이는 물체는 잠들지 않아야 한다.
+bool CheckSleepAndWake() {
+    JobSystem jobs(2);
+    Scene scene(16);
+    GameEvents events;
+    PhysicsSystem physics(jobs);
+    physics.SetBroadPhase(BroadPhaseMode::None);
+    const double dt = 1.0 / PHYSICS_HZ;
+    const Entity resting = scene.CreateEntity(), mover = scene.CreateEntity();
+    scene.SetTransform(resting, { 10.0, 10.0 });
+    scene.Add(resting, PhysicsComponent{});
+    scene.SetTransform(mover, { 30.0, 10.0 });
+    scene.Add(mover, PhysicsComponent{ 1.0, 0.0 });
+    auto tick = [&](bool updateSleeping) {
+        physics.UpdateParallel(scene, events, dt);
+        if (updateSleeping) scene.UpdateSleeping();
+    };
+    auto x = [&](Entity e) { return scene.Get<TransformComponent>(e)->x; };
+
+    int ticksToSleep = 0;
+    while (!scene.IsSleeping(resting) && ticksToSleep < 10) { tick(true); ++ticksToSleep; }
+    const bool fellAsleep = scene.IsSleeping(resting) && !scene.IsSleeping(mover);
+
+    // 잠든 동안은 속도가 있어도 적분하지 않는다 (UpdateSleeping 을 부르지 않으면 깨지도 않음)
+    scene.Each<TransformComponent, PhysicsComponent>([&](TransformComponent& t, PhysicsComponent& v) { if (t.x == 10.0) v.vx = 5.0; });
+    for (int t = 0; t < 5; ++t) tick(false);
+    const bool skipped = scene.IsSleeping(resting) && x(resting) == 10.0;
+
+    scene.SetVelocity(resting, PhysicsComponent{ 2.0, 0.0 });
+    const bool woke = !scene.IsSleeping(resting) && x(resting) == 10.0 && scene.Get<TransformComponent>(resting)->y == 10.0;
+    tick(false);
+    const bool integrated = std::abs(x(resting) - (10.0 + 2.0 * dt)) < 1e-12;
+
+    if (!fellAsleep || !skipped || !woke || !integrated) {
+        printf("[Check] sleep and wake: asleep after %d ticks %d, skipped while asleep %d, woke in place %d, integrated after wake %d (x %.17g)\n",
+            ticksToSleep, fellAsleep, skipped, woke, integrated, x(resting));
+        return false;
+    }
+    return true;
+}
+
+// 바뀐 행만 쓰는 델타 복사가 매 틱 모든 행을 다시 계산하는 경로와 모든 transform 버퍼에서 비트 단위로 같은지.
+// 같은 장면 둘에 같은 조작 (SetTransform, SetVelocity, 컴포넌트 추가/제거로 아키타입 옮기기, 생성/파괴, 재우기/깨우기)을
+// 똑같이 가하고, 틱마다 청크 배치와 버퍼 전부를 비교한다. 움직이는 물체는 드물게 두고 재우기도 가끔만 해서,
+// 멈췄지만 아직 깨어 있는 행(다른 버퍼에서 낡은 행)만 있는 캐시 라인이 생기게 한다.
+bool CheckDeltaCopyMatchesFull() {
+    const EntityIndex n = ENTITY_CHUNK_SIZE + 1000;
+    const int ticks = 400;
+    JobSystem jobs(2);
+    struct Setup {
+        Scene scene;
+        GameEvents events;
+        PhysicsSystem physics;
+        Setup(EntityIndex n, JobSystem& jobs) : scene(n), physics(jobs) {}
+    };
+    Setup delta(n, jobs), full(n, jobs);
+    full.physics.SetDeltaCopy(false);
+    for (Setup* s : { &delta, &full }) s->physics.SetBroadPhase(BroadPhaseMode::None);
+
+    uint32_t seed = 99;
+    auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+    auto velocity = [&]() { return rnd() < 0.9 ? PhysicsComponent{} : PhysicsComponent{ (rnd() - 0.5) * PHYSICS_HZ, (rnd() - 0.5) * PHYSICS_HZ }; };
+    auto both = [&](auto&& op) { op(delta.scene); op(full.scene); };
+
+    std::vector<Entity> entities;
+    for (EntityIndex i = 0; i < n - 64; ++i) {
+        const TransformComponent pos{ rnd() * WORLD_MAX_X, rnd() * WORLD_MAX_Y };
+        const PhysicsComponent vel = velocity();
+        Entity e;
+        both([&](Scene& scene) { e = scene.CreateEntity(); scene.SetTransform(e, pos); scene.Add(e, vel); });
+        entities.push_back(e);
+    }
+
+    auto same = [&]() {
+        std::vector<const ArchetypeChunk*> a, b;
+        delta.scene.CollectChunks<TransformComponent>(a);
+        full.scene.CollectChunks<TransformComponent>(b);
+        if (a.size() != b.size()) return false;
+        for (size_t c = 0; c < a.size(); ++c) {
+            const uint32_t rows = a[c]->Count();
+            if (rows != b[c]->Count() || std::memcmp(a[c]->Entities(), b[c]->Entities(), rows * sizeof(EntityIndex))) return false;
+            for (int buffer = 0; buffer < TRANSFORM_BUFFERS; ++buffer) {
+                const ConstTransformColumns pa = a[c]->Columns<TransformComponent>(buffer), pb = b[c]->Columns<TransformComponent>(buffer);
+                if (std::memcmp(pa.x, pb.x, rows * sizeof(double)) || std::memcmp(pa.y, pb.y, rows * sizeof(double))) return false;
+            }
+        }
+        return true;
+    };
+
+    int firstMismatch = -1;
+    for (int tick = 0; tick < ticks && firstMismatch < 0; ++tick) {
+        for (int k = 0; k < 8; ++k) {
+            const Entity e = entities[(size_t)(rnd() * entities.size())];
+            const TransformComponent pos{ rnd() * WORLD_MAX_X, rnd() * WORLD_MAX_Y };
+            const PhysicsComponent vel = velocity();
+            if (k % 2) both([&](Scene& scene) { scene.SetTransform(e, pos); });
+            else both([&](Scene& scene) { scene.SetVelocity(e, vel); });
+        }
+        if (tick % 7 == 0) {
+            const size_t victim = (size_t)(rnd() * entities.size());
+            const Entity a = entities[(size_t)(rnd() * entities.size())], b = entities[(size_t)(rnd() * entities.size())];
+            const TransformComponent pos{ rnd() * WORLD_MAX_X, rnd() * WORLD_MAX_Y };
+            const PhysicsComponent vel = velocity();
+            Entity created;
+            both([&](Scene& scene) {
+                scene.Remove<PhysicsComponent>(a);                 // 물리 밖으로 (나중에 SetVelocity 로 다시 들어옴)
+                scene.Add(b, RenderComponent{ '*' });              // 물리 아키타입끼리 옮기기
+                scene.DestroyEntity(entities[victim]);
+                created = scene.CreateEntity();
+                scene.SetTransform(created, pos);
+                scene.Add(created, vel);
+            });
+            entities[victim] = created;
+        }
+        if (tick % 50 == 25) {
+            // Each 로 속도를 바꾸면 잠든 청크까지 모든 행이 바뀐 것으로 표시된다
+            both([&](Scene& scene) { scene.Each<PhysicsComponent>([](PhysicsComponent& v) { v.vx *= 0.5; }); });
+        }
+        delta.physics.UpdateParallel(delta.scene, delta.events, 1.0 / PHYSICS_HZ);
+        full.physics.UpdateParallel(full.scene, full.events, 1.0 / PHYSICS_HZ);
+        if (tick % 10 == 9) both([&](Scene& scene) { scene.UpdateSleeping(); });
+        for (Setup* s : { &delta, &full }) { std::vector<CollisionEvent> drained; s->events.Channel<CollisionEvent>().DrainInto(drained); }
+        if (!same()) firstMismatch = tick;
+    }
+
+    if (firstMismatch >= 0) {
+        printf("[Check] delta copy: transform buffers differ from the full copy after tick %d\n", firstMismatch);
+        return false;
+    }
+    return true;
+}
+
+// 고정 스텝 누산기와 렌더 보간. 128Hz 스텝과 1/1024초 단위 프레임 간격만 쓰므로 모든 값이 이진수로 정확하다.
+// 누산기를 정수(1/1024초)로 따로 세어 프레임마다 스텝 수, 넘친 시간 버리기, alpha 를 비교하고,
+// 그려지는 위치가 x0 + v * dt * (스텝 수 - 1 + alpha) 와 정확히 같은지 (alpha 0 이면 앞 스텝의 발행된 위치 그대로) 본다.
+bool CheckFixedTimestep() {
+    const int hz = 128, maxSubsteps = 8, unitsPerStep = 1024 / hz;
+    const int frames = 400;
+    JobSystem jobs(2);
+    Scene scene(16);
+    GameEvents events;
+    PhysicsSystem physics(jobs);
+    physics.SetBroadPhase(BroadPhaseMode::None);
+    RenderSystem render(jobs);
+    FixedTimestep timestep(hz, maxSubsteps);
+    const double x0 = 10.0, v = 1.0;
+    const Entity body = scene.CreateEntity();
+    scene.SetTransform(body, { x0, 5.0 });
+    scene.Add(body, PhysicsComponent{ v, 0.0 });
+    scene.Add(body, RenderComponent{ 'o' });
+
+    uint32_t seed = 5;
+    auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    int accumulator = 0;        // 1/1024초 단위
+    uint64_t totalSteps = 0, dropped = 0;
+    int badFrame = -1;
+    for (int frame = 0; frame < frames && badFrame < 0; ++frame) {
+        int units = 4 + (int)(rnd() % 27);         // 4..30ms
+        if (frame % 97 == 50) units = 1024 + 3;    // 1초 멈춤
+        accumulator += units;
+        int expected = accumulator / unitsPerStep;
+        if (expected > maxSubsteps) { dropped += expected - maxSubsteps; expected = maxSubsteps; }
+        accumulator %= unitsPerStep;
+
+        const int steps = timestep.Advance(units / 1024.0);
+        for (int step = 0; step < steps; ++step) physics.UpdateParallel(scene, events, timestep.Dt());
+        totalSteps += steps;
+        const double alpha = timestep.Alpha();
+        render.BeginFrame(scene, alpha);
+
+        const std::optional<TransformComponent> drawn = render.DrawnTransform(scene, body);
+        const double published = scene.Get<TransformComponent>(body)->x;
+        const bool stepsOk = steps == expected && timestep.DroppedSteps() == dropped;
+        const bool alphaOk = alpha >= 0.0 && alpha < 1.0 && alpha == (double)accumulator / unitsPerStep;
+        const bool drawnOk = totalSteps == 0 || (drawn && published == x0 + v * timestep.Dt() * totalSteps
+            && drawn->x == x0 + v * timestep.Dt() * ((double)totalSteps - 1 + alpha));
+        if (!stepsOk || !alphaOk || !drawnOk) {
+            printf("[Check] fixed timestep: frame %d (+%d/1024s) ran %d steps (expected %d), dropped %llu (expected %llu), alpha %.17g, drawn x %.17g, published x %.17g\n",
+                frame, units, steps, expected, (unsigned long long)timestep.DroppedSteps(), (unsigned long long)dropped,
+                alpha, drawn ? drawn->x : -1.0, published);
+            badFrame = frame;
+        }
+    }
+    return badFrame < 0 && dropped > 0;
+}
+
+// 물리가 틱을 도는 동안 여러 독자가 ReadSnapshot 으로 위치를 읽을 때, 통과한 스냅샷이 언제나 한 프레임의 값인지.
+// 모든 엔티티가 같은 자리에서 같은 속도로 움직이므로 프레임 f 의 x 는 모두 expected[f] 여야 한다.
+// 독자는 몇 번에 한 번 절반만 읽고 작성자가 그 버퍼를 다시 쓸 때까지 기다린다. 이런 시도는 Validate 에서 걸러져야 한다.
+bool CheckTransformSnapshots() {
+    const EntityIndex n = ENTITY_CHUNK_SIZE * 4;
+    const int ticks = 2000;
+    const double dt = 1.0 / 1024, x0 = 1.0;
+    std::vector<double> expected(ticks + 1, x0);
+    for (int f = 1; f <= ticks; ++f) expected[f] = expected[f - 1] + 1.0 * dt;
+
+    Scene scene(n);
+    for (EntityIndex i = 0; i < n; ++i) {
+        Entity e = scene.CreateEntity();
+        scene.SetTransform(e, { x0, 1.0 });
+        scene.Add(e, PhysicsComponent{ 1.0, 0.0 });
+    }
+    std::vector<const ArchetypeChunk*> chunks;
+    scene.CollectChunks<TransformComponent, PhysicsComponent>(chunks);
+
+    std::atomic<int> published{ 0 };
+    std::atomic<bool> writerDone{ false };
+    std::thread writer([&] {
+        JobSystem jobs(2);
+        GameEvents events;
+        PhysicsSystem physics(jobs);
+        physics.SetBroadPhase(BroadPhaseMode::None);
+        for (int t = 0; t < ticks; ++t) {
+            physics.UpdateParallel(scene, events, dt);
+            published.fetch_add(1, std::memory_order_release);
+        }
+        writerDone.store(true, std::memory_order_release);
+    });
+
+    struct ReaderResult { uint64_t reads = 0, attempts = 0, forced = 0, bad = 0, backwards = 0; };
+    const int readerCount = 2;
+    std::vector<ReaderResult> results(readerCount);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r] {
+            ReaderResult& out = results[r];
+            uint64_t lastFrame = 0;
+            while (!writerDone.load(std::memory_order_acquire)) {
+                double lo = 0, hi = 0;
+                const bool stall = out.reads % 8 == 7;
+                bool stalled = false;
+                const uint64_t frame = scene.ReadSnapshot([&](const TransformSnapshot& snapshot) {
+                    ++out.attempts;
+                    lo = 1e300; hi = -1e300;
+                    for (size_t c = 0; c < chunks.size(); ++c) {
+                        const ConstTransformColumns pos = chunks[c]->Columns<TransformComponent>(snapshot.Buffer());
+                        for (uint32_t i = 0; i < chunks[c]->Count(); ++i) { lo = std::min(lo, pos.x[i]); hi = std::max(hi, pos.x[i]); }
+                        // 절반쯤 읽고 작성자가 세 번 더 발행할 때까지 (이 버퍼를 한 번은 다시 쓸 때까지) 기다린다.
+                        // 첫 발행 전의 버퍼(프레임 0)는 작성자가 다시 쓰지 않으므로 기다려도 찢어지지 않는다.
+                        if (stall && !stalled && c == chunks.size() / 2 && snapshot.Frame() > 0) {
+                            stalled = true;
+                            const int until = published.load(std::memory_order_acquire) + 3;
+                            while (published.load(std::memory_order_acquire) < until && !writerDone.load(std::memory_order_acquire))
+                                std::this_thread::yield();
+                            if (published.load(std::memory_order_acquire) >= until) ++out.forced;
+                        }
+                    }
+                });
+                ++out.reads;
+                out.bad += frame > (uint64_t)ticks || lo != hi || lo != expected[frame];
+                out.backwards += frame < lastFrame;
+                lastFrame = frame;
+            }
+        });
+    }
+    writer.join();
+    for (auto& reader : readers) reader.join();
+
+    bool ok = true;
+    for (const ReaderResult& out : results) {
+        const uint64_t retries = out.attempts - out.reads;
+        if (out.bad || out.backwards || retries < out.forced || out.forced == 0) {
+            printf("[Check] transform snapshots: %llu reads, %llu inconsistent, %llu went backwards, %llu retries for %llu forced tears\n",
+                (unsigned long long)out.reads, (unsigned long long)out.bad, (unsigned long long)out.backwards,
+                (unsigned long long)retries, (unsigned long long)out.forced);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// 격자와 정렬 후 훑기가 모든 쌍을 직접 비교한 결과와 같은 쌍을 찾는지.
+// 라운드마다 물체를 조금씩 움직이고, 몇 개는 순간이동시키고, 몇 개는 빠졌다 다시 들어오게 해서
+// 정렬 후 훑기의 삽입 정렬, 일반 정렬로의 후퇴, 물체 추가/제거 경로를 모두 지나게 한다.
+bool CheckBroadPhaseMatchesBruteForce() {
+    const EntityIndex n = 3000;
+    const int rounds = 20;
+    JobSystem jobs(4);
+    UniformGridBroadPhase grid(jobs);
+    SweepAndPruneBroadPhase sweep(jobs);
+    std::vector<WorkerPairs> pairs(jobs.WorkerCount());
+    std::vector<uint64_t> found, expected, temp;
+
+    uint32_t seed = 4242;
+    auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+    std::vector<double> x(n), y(n);
+    for (EntityIndex i = 0; i < n; ++i) {
+        // 절반은 한곳에 몰아 쌍이 많이 생기게
+        if (i % 2) { x[i] = 40 + (rnd() - 0.5) * 16; y[i] = 12 + (rnd() - 0.5) * 8; }
+        else { x[i] = rnd() * WORLD_MAX_X; y[i] = rnd() * WORLD_MAX_Y; }
+    }
+
+    uint32_t wrongRounds = 0;
+    size_t totalPairs = 0;
+    CollisionBodies bodies;
+    for (int round = 0; round < rounds; ++round) {
+        bodies.x.clear(); bodies.y.clear(); bodies.owners.clear();
+        for (EntityIndex i = 0; i < n; ++i) {
+            if (i % 97 == (EntityIndex)round) { x[i] = rnd() * WORLD_MAX_X; y[i] = rnd() * WORLD_MAX_Y; }
+            else {
+                x[i] = std::clamp(x[i] + (rnd() - 0.5) * 0.2, 0.0, WORLD_MAX_X);
+                y[i] = std::clamp(y[i] + (rnd() - 0.5) * 0.2, 0.0, WORLD_MAX_Y);
+            }
+            if ((i + round) % 50 == 0) continue;
+            bodies.x.push_back(x[i]); bodies.y.push_back(y[i]); bodies.owners.push_back(i);
+        }
+
+        expected.clear();
+        for (uint32_t i = 0; i < bodies.Count(); ++i)
+            for (uint32_t j = i + 1; j < bodies.Count(); ++j)
+                if (BodiesOverlap(bodies.x[i], bodies.y[i], bodies.x[j], bodies.y[j]))
+                    expected.push_back(CollisionPairKey(MakeCollisionPair(bodies.owners[i], bodies.owners[j])));
+        std::sort(expected.begin(), expected.end());
+        totalPairs += expected.size();
+
+        for (auto& worker : pairs) worker.pairs.clear();
+        grid.FindPairs(bodies, pairs);
+        MergeCollisionPairs(pairs, found, temp);
+        bool wrong = found != expected;
+
+        for (auto& worker : pairs) worker.pairs.clear();
+        sweep.FindPairs(bodies, pairs);
+        MergeCollisionPairs(pairs, found, temp);
+        wrong |= found != expected;
+        wrongRounds += wrong;
+    }
+
+    if (wrongRounds || totalPairs == 0) {
+        printf("[Check] broad-phase vs brute force: %u/%d rounds differ, %zu pairs expected\n", wrongRounds, rounds, totalPairs);
+        return false;
+    }
+    return true;
+}
+
+// 멈춰서 겹쳐 있는 두 물체는 접촉이 시작된 틱에 한 번만 쌍 이벤트를 내고, 떨어졌다가 다시 닿으면 한 번 더 내는지.
+bool CheckContactStartEvents() {
+    bool ok = true;
+    for (BroadPhaseMode mode : { BroadPhaseMode::UniformGrid, BroadPhaseMode::SweepAndPrune }) {
+        JobSystem jobs(2);
+        Scene scene(16);
+        GameEvents events;
+        PhysicsSystem physics(jobs);
+        physics.SetBroadPhase(mode);
+        const Entity a = scene.CreateEntity(), b = scene.CreateEntity();
+        scene.SetTransform(a, { 20.0, 10.0 });
+        scene.SetTransform(b, { 20.5, 10.0 });
+        scene.Add(a, PhysicsComponent{});
+        scene.Add(b, PhysicsComponent{});
+        std::vector<CollisionEvent> drained;
+        auto tick = [&](int count) {
+            for (int t = 0; t < count; ++t) {
+                physics.UpdateParallel(scene, events, 1.0 / PHYSICS_HZ);
+                events.Channel<CollisionEvent>().DrainInto(drained);
+            }
+        };
+        tick(10);
+        const size_t resting = drained.size();
+        scene.SetTransform(b, { 40.0, 10.0 });
+        tick(3);
+        scene.SetTransform(b, { 20.5, 10.0 });
+        tick(10);
+        if (resting != 1 || drained.size() != 2 || drained[0].a != a || drained[0].b != b) {
+            printf("[Check] contact start events (%s): %zu events while resting, %zu after touching again\n",
+                mode == BroadPhaseMode::UniformGrid ? "grid" : "sweep", resting, drained.size());
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// 같은 장면을 작업자 1개와 4개로, 격자와 정렬 후 훑기로 몇 틱씩 돌려 꺼낸 CollisionEvent 순서가 모두 같은지.
+bool CheckBroadPhaseDeterminism() {
+    const EntityIndex n = 3000;
+    const int ticks = 30;
+    auto run = [&](BroadPhaseMode mode, unsigned workers) {
+        JobSystem jobs(workers);
+        Scene scene(n);
+        GameEvents events;
+        PhysicsSystem physics(jobs);
+        physics.SetBroadPhase(mode);
+        uint32_t seed = 777;
+        auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / double(1 << 24); };
+        for (EntityIndex i = 0; i < n; ++i) {
+            Entity e = scene.CreateEntity();
+            if (i % 2) scene.SetTransform(e, { 40 + (rnd() - 0.5) * 16, 12 + (rnd() - 0.5) * 8 });
+            else scene.SetTransform(e, { rnd() * WORLD_MAX_X, rnd() * WORLD_MAX_Y });
+            scene.Add(e, PhysicsComponent{ (rnd() - 0.5) * 0.5 * PHYSICS_HZ, (rnd() - 0.5) * 0.5 * PHYSICS_HZ });
+        }
+        std::vector<CollisionEvent> drained;
+        for (int tick = 0; tick < ticks; ++tick) {
+            physics.UpdateParallel(scene, events, 1.0 / PHYSICS_HZ);
+            events.Channel<CollisionEvent>().DrainInto(drained);
+        }
+        return drained;
+    };
+
+    const std::vector<CollisionEvent> reference = run(BroadPhaseMode::UniformGrid, 1);
+    size_t entityPairs = 0, walls = 0;
+    for (const CollisionEvent& ev : reference) (ev.b == WALL_ENTITY ? walls : entityPairs)++;
+
+    bool ok = entityPairs > 0 && walls > 0;
+    const struct { BroadPhaseMode mode; unsigned workers; const char* name; } runs[] = {
+        { BroadPhaseMode::UniformGrid, 4, "grid, 4 workers" },
+        { BroadPhaseMode::SweepAndPrune, 1, "sweep, 1 worker" },
+        { BroadPhaseMode::SweepAndPrune, 4, "sweep, 4 workers" },
+    };
+    for (const auto& r : runs) {
+        const std::vector<CollisionEvent> events = run(r.mode, r.workers);
+        const bool same = events.size() == reference.size()
+            && std::equal(events.begin(), events.end(), reference.begin(),
+                [](const CollisionEvent& a, const CollisionEvent& b) { return a.a == b.a && a.b == b.b; });
+        if (!same) {
+            printf("[Check] broad-phase determinism: %s gave %zu events, grid with 1 worker gave %zu (%zu pairs, %zu walls)\n",
+                r.name, events.size(), reference.size(), entityPairs, walls);
+            ok = false;
+        }
+    }
+    if (entityPairs == 0 || walls == 0)
+        printf("[Check] broad-phase determinism: scene produced %zu pairs and %zu wall hits\n", entityPairs, walls);
+    return ok;
+}
+
+// 여러 생산자가 Push/PushBatch 하는 중에 Close 해도, 긴 timeout 으로 잠든 게임 로직 스레드가 곧바로 깨어나
+// 그때까지 들어온 이벤트를 하나도 빠뜨리지 않고 처리한 뒤 끝나는지. 체력이 없는 엔티티라 적용(출력)은 없고 지연만 기록된다.
+bool CheckLogicThreadClose() {
+    Scene scene(16);
+    const Entity target = scene.CreateEntity();
+    GameEvents events;
+    events.SetPushStamps(true);
+    std::mutex stateMutex;
+    DamageSystem damage;
+    std::thread logic([&] { damage.RunUntilClosed(scene, events, stateMutex, std::chrono::seconds(10)); });
+
+    const int producers = 3, perProducer = 2000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            EventQueue<CollisionEvent>& channel = events.Channel<CollisionEvent>();
+            std::vector<CollisionEvent> batch(50, CollisionEvent{ target, WALL_ENTITY });
+            for (int i = 0; i < perProducer; i += (int)batch.size()) {
+                if (p == 0) channel.PushBatch(batch);
+                else for (const CollisionEvent& ev : batch) channel.Push(ev);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));   // 로직 스레드가 다시 잠들게
+    const auto closedAt = std::chrono::steady_clock::now();
+    events.Close();
+    logic.join();
+    const double exitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - closedAt).count();
+
+    const uint64_t expected = (uint64_t)producers * perProducer;
+    if (damage.QueueLatency().Count() != expected || damage.ApplyLatency().Count() != expected || exitMs > 1000.0) {
+        printf("[Check] logic thread close: %llu/%llu events seen, exited %.1fms after Close\n",
+            (unsigned long long)damage.QueueLatency().Count(), (unsigned long long)expected, exitMs);
+        return false;
+    }
+    return true;
+}
+
+// 히스토그램의 백분위가 실제 값보다 작지 않고 25% 넘게 크지 않은지 (64비트 전체 범위의 값으로).
+bool CheckLatencyHistogram() {
+    bool ok = true;
+    for (uint64_t scale : { 1ull, 1000ull, 1ull << 40 }) {
+        LatencyHistogram histogram;
+        const uint64_t count = 1000;
+        for (uint64_t i = 1; i <= count; ++i) histogram.Record((int64_t)(i * scale));
+        for (double fraction : { 0.01, 0.5, 0.99 }) {
+            const uint64_t exact = (uint64_t)std::ceil(fraction * count) * scale;
+            const uint64_t reported = histogram.PercentileNs(fraction);
+            if (reported < exact || (double)reported > (double)exact * 1.25) {
+                printf("[Check] latency histogram: p%g of 1..%llu x %llu is %llu, exact %llu\n", fraction * 100,
+                    (unsigned long long)count, (unsigned long long)scale, (unsigned long long)reported, (unsigned long long)exact);
+                ok = false;
+            }
+        }
+        ok &= histogram.Count() == count && histogram.MaxNs() == count * scale;
+    }
+    return ok;
+}
+
+bool RunChecks(const std::string& which) {
+    struct Check { const char* group; const char* name; bool (*run)(); };
+    const Check checks[] = {
+        { "queue", "overflow batch wakes consumer", CheckQueueOverflowBatch },
+        { "queue", "close wakes waiters, keeps leftovers", CheckQueueCloseWakesWaiters },
+        { "queue", "waits honor their deadline", CheckQueueDeadline },
+        { "queue", "overflow batch through WaitPopBatch", CheckQueueOverflowWaitBatch },
+        { "eventcount", "ping-pong loses no wakeups", CheckEventCountPingPong },
+        { "eventcount", "timed wait expires, notify skips sleep", CheckEventCountTimedWait },
+        { "jobs", "more live jobs than the pool", CheckJobPoolOverflow },
+        { "scene", "stale handles miss a reused slot", CheckStaleHandles },
+        { "scene", "resting bodies sleep, SetVelocity wakes", CheckSleepAndWake },
+        { "snapshot", "readers see whole transform frames", CheckTransformSnapshots },
+        { "delta", "delta copy matches full copy", CheckDeltaCopyMatchesFull },
+        { "timestep", "substeps, clamp and interpolation", CheckFixedTimestep },
+        { "broadphase", "grid and sweep match brute force", CheckBroadPhaseMatchesBruteForce },
+        { "broadphase", "same events for any worker count", CheckBroadPhaseDeterminism },
+        { "broadphase", "resting contact reports only its start", CheckContactStartEvents },
+        { "logic", "close drains every pushed event", CheckLogicThreadClose },
+        { "logic", "latency percentiles within 25%", CheckLatencyHistogram },
+    };
+    bool ok = true;
+    for (const Check& check : checks) {
+        if (!which.empty() && which != check.group) continue;
+        const bool passed = check.run();
+        printf("[Check] %-10s %-40s %s\n", check.group, check.name, passed ? "ok" : "FAILED");
+        ok &= passed;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    std::ios_base::sync_with_stdio(false);
+
+    // Thread.exe --bench [queue|layout|simd|delta|broadphase|pacing] : 이름을 생략하면 전부 실행
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        const std::string which = argc > 2 ? argv[2] : "";
+        if (which.empty() || which == "queue") RunEventQueueBenchmark();
+        if (which.empty() || which == "layout") RunLayoutBenchmark();
+        if (which.empty() || which == "simd") RunSimdBenchmark();
+        if (which.empty() || which == "delta") RunDeltaCopyBenchmark();
+        if (which.empty() || which == "broadphase") RunBroadPhaseBenchmark();
+        if (which.empty() || which == "pacing") RunFramePacingBenchmark();
+        return 0;
+    }
+
+    // Thread.exe --check [queue|eventcount|jobs|scene|snapshot|delta|timestep|broadphase|logic] : 동작 점검. 실패가 있으면 종료 코드 1
+    if (argc > 1 && std::string(argv[1]) == "--check") return RunChecks(argc > 2 ? argv[2] : "") ? 0 : 1;
+
+    Scene scene;
+    GameEvents events;
+    JobSystem jobs;
+    PhysicsSystem physicsSystem(jobs);
+    RenderSystem renderSystem(jobs);
+    DamageSystem damageSystem;
+    Renderer renderer;
+
+    // 엔티티 생성 (속도는 초당 거리)
+    Entity player = scene.CreateEntity();
+    scene.SetTransform(player, { 40.0, 12.0 });
+    scene.Add(player, PhysicsComponent{ 30.0, 12.0 });
+    scene.Add(player, RenderComponent{ '@' });
+    scene.Add(player, HealthComponent{ 100 });
+
+    Entity mob = scene.CreateEntity();
+    scene.SetTransform(mob, { 10.0, 5.0 });
+    scene.Add(mob, PhysicsComponent{ -18.0, 6.0 });
+    scene.Add(mob, RenderComponent{ 'M' });
+    scene.Add(mob, HealthComponent{ 50 });
+
+    // 시스템은 접근 선언만 하고 순서는 스케줄러가 정한다. 물리와 렌더 수집은 서로 충돌하지 않아 동시에 돌고,
+    // 그리기는 수집(패킷)이 끝난 뒤에 돈다. 각 시스템은 안에서 다시 ParallelFor 로 퍼진다.
+    // 물리는 프레임마다 누산기가 정한 수만큼 고정 dt 스텝을 돈다.
+    // 데미지는 프레임에 묶이지 않는다: 게임 로직 스레드가 큐에서 기다리다 물리가 push 하는 즉시 체력을 깎는다.
+    // 체력과 콘솔은 그리기와 같이 쓰고, 데미지의 생존 확인은 Scene 구조(엔티티 위치, 세대)를 읽는다.
+    // 그래서 로직 스레드가 도는 동안 체력, 콘솔, Scene 구조 변경은 모두 stateMutex 를 잡고 한다.
+    std::vector<RenderPacket> packets;
+    std::mutex stateMutex;
+    FixedTimestep timestep(PHYSICS_HZ, MAX_PHYSICS_SUBSTEPS);
+    int physicsSteps = 0;
+    SystemScheduler scheduler(jobs);
+    scheduler.Add("Physics", PhysicsSystem::Access(), [&] {
+        for (int step = 0; step < physicsSteps; ++step) physicsSystem.UpdateParallel(scene, events, timestep.Dt());
+    });
+    scheduler.Add("RenderCollect", RenderSystem::Access(), [&] { renderSystem.CollectParallel(scene, packets); });
+    scheduler.Add("Draw", Renderer::Access(), [&] {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        renderer.Draw(packets, scene);
+    });
+
+    events.SetPushStamps(true);
+    std::thread logic([&] { damageSystem.RunUntilClosed(scene, events, stateMutex, std::chrono::milliseconds(100)); });
+
+    FramePacer pacer(std::chrono::microseconds(1000000 / 60)); // 60Hz
+    const auto runTime = std::chrono::seconds(10);
+    auto start = std::chrono::steady_clock::now();
+    auto lastAdvance = start;
+    pacer.Reset();
+    while (std::chrono::steady_clock::now() - start < runTime) {
+        auto t0 = std::chrono::steady_clock::now();
+
+        // 렌더는 지난 프레임까지의 마지막 두 스텝 사이를 그때의 alpha 로 그린다 (한 프레임 늦음).
+        // 그다음 이번 프레임에 흐른 시간만큼 물리 스텝 수를 정한다.
+        renderSystem.BeginFrame(scene, timestep.Alpha());
+        physicsSteps = timestep.Advance(std::chrono::duration<double>(t0 - lastAdvance).count());
+        lastAdvance = t0;
+
+        scheduler.RunFrame();
+        {
+            // 구조 변경은 시스템이 모두 끝난 프레임 사이에서. 로직 스레드는 프레임과 무관하게 읽으므로 잠금도 잡는다.
+            std::lock_guard<std::mutex> lock(stateMutex);
+            scene.UpdateSleeping();
+        }
+
+        pacer.Wait();
+    }
+
+    events.Close();
+    logic.join();
+
+    damageSystem.QueueLatency().Print("push->pop");
+    damageSystem.ApplyLatency().Print("push->apply");
+    const FramePacer::JitterStats pacing = pacer.Stats();
+    printf("[Pacer] %llu frames, wake late mean %.1fus, stddev %.1fus, max %.1fus, overruns %llu\n",
+        (unsigned long long)pacing.frames, pacing.meanUs, pacing.stddevUs, pacing.maxUs, (unsigned long long)pacing.overruns);
+    printf("Execution finished.\n");
+    return 0;
 }